@@ -0,0 +1,290 @@
+/*
+*  Benchmarks for ci_traits. Each is run against the current traits and against legacy_ci_traits, a copy of the implementation
+*  before case folding moved to lookup tables, so any change to the kernels can be measured against where we started.
+*  The wide runs only reach the vector kernels where wchar_t is 16 bits, so elsewhere they measure the table fold.
+*/
+
+#include "ci_traits.h"
+#include "ci_flat_map.h"
+
+#include <cctype>
+#include <cstddef>
+#include <cwctype>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "bench_harness.h"
+#include "bench_data.h"
+
+namespace {
+
+	using dp_bench::state;
+	namespace data = dp_bench::data;
+
+	//Range checks for char, towupper for wchar_t
+	template<typename CharT>
+	class legacy_ci_traits : public std::char_traits<CharT> {
+
+		static char upper(char in) {
+			return (in >= 'A' && in <= 'Z') ? static_cast<char>(in + 'a' - 'A') : in;
+		}
+		static wchar_t upper(wchar_t in) {
+			return static_cast<wchar_t>(std::towupper(static_cast<std::wint_t>(in)));
+		}
+
+	public:
+		static bool eq(CharT lhs, CharT rhs) {
+			return upper(lhs) == upper(rhs);
+		}
+		static bool lt(CharT lhs, CharT rhs) {
+			return upper(lhs) < upper(rhs);
+		}
+		static int compare(const CharT* lhs, const CharT* rhs, std::size_t n) {
+			while (n-- != 0) {
+				if (upper(*lhs) < upper(*rhs)) return -1;
+				if (upper(*lhs) > upper(*rhs)) return 1;
+				++lhs;
+				++rhs;
+			}
+			return 0;
+		}
+		static const CharT* find(const CharT* str, std::size_t n, CharT ch) {
+			const CharT upper_ch = upper(ch);
+			while (n-- != 0) {
+				if (upper(*str) == upper_ch) return str;
+				++str;
+			}
+			return NULL;
+		}
+	};
+
+	//The usual way to hash ignoring case without ci_hash: fold a copy, then hash that
+	struct legacy_ci_hash {
+		std::size_t operator()(const dp::ci_string& in) const {
+			std::string folded(in.data(), in.size());
+			for (std::size_t i = 0; i < folded.size(); ++i) folded[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(folded[i])));
+			return std::hash<std::string>()(folded);
+		}
+	};
+
+	//Pairs of equal strings of the given length, in differing case, so every comparison runs to the end
+	template<typename CharT>
+	std::vector<std::basic_string<CharT> > mixed_case_text(std::size_t length, unsigned long long seed, bool latin1) {
+		data::rng gen(seed);
+		std::vector<std::basic_string<CharT> > out;
+		for (std::size_t i = 0; i < 2 * data::batch_size * 16 / (length + 16); ++i) {
+			std::basic_string<CharT> lower;
+			std::basic_string<CharT> upper;
+			for (std::size_t j = 0; j < length; ++j) {
+				const bool accented = latin1 && gen.below(4) == 0;
+				const unsigned long letter = accented ? 0xE0 + gen.below(23) : 'a' + gen.below(26);
+				lower += static_cast<CharT>(letter);
+				upper += static_cast<CharT>(gen.below(2) == 0 ? letter - 0x20 : letter);
+			}
+			out.push_back(lower);
+			out.push_back(upper);
+		}
+		return out;
+	}
+
+	template<typename Traits, typename CharT>
+	void compare_pairs(state& st, const std::vector<std::basic_string<CharT> >& input) {
+		st.set_items_per_iteration(input.size() / 2 * input[0].size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i + 1 < input.size(); i += 2) {
+				dp_bench::do_not_optimize(Traits::compare(input[i].data(), input[i + 1].data(), input[i].size()));
+			}
+		}
+	}
+
+	//Searching for a character which isn't there, so every search runs to the end
+	template<typename Traits, typename CharT>
+	void find_missing(state& st, const std::vector<std::basic_string<CharT> >& input) {
+		st.set_items_per_iteration(input.size() * input[0].size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < input.size(); ++i) {
+				dp_bench::do_not_optimize(Traits::find(input[i].data(), input[i].size(), CharT('#')));
+			}
+		}
+	}
+
+	template<typename Hash>
+	void hash_all(state& st, const std::vector<std::string>& input) {
+		std::vector<dp::ci_string> keys;
+		for (std::size_t i = 0; i < input.size(); ++i) keys.push_back(dp::ci_string(input[i].data(), input[i].size()));
+		st.set_items_per_iteration(keys.size());
+		const Hash hasher = Hash();
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < keys.size(); ++i) {
+				dp_bench::do_not_optimize(hasher(keys[i]));
+			}
+		}
+	}
+
+	//Every lookup hits, with the key in a different case from the one stored
+	template<typename Set>
+	void lookup_all(state& st, const std::vector<std::string>& input) {
+		Set set;
+		for (std::size_t i = 0; i < input.size(); i += 2) set.insert(dp::ci_string(input[i].data(), input[i].size()));
+		std::vector<dp::ci_string> keys;
+		for (std::size_t i = 1; i < input.size(); i += 2) keys.push_back(dp::ci_string(input[i].data(), input[i].size()));
+		st.set_items_per_iteration(keys.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < keys.size(); ++i) {
+				dp_bench::do_not_optimize(set.count(keys[i]));
+			}
+		}
+	}
+
+	//Words as keys, as in a dictionary of headers or settings, with the lookup keys in a random mix of case
+	const std::vector<dp::ci_string>& dictionary_keys() {
+		static const std::vector<dp::ci_string> keys = [] {
+			const std::vector<std::string> words = data::ascii_text();
+			std::vector<dp::ci_string> out;
+			for (std::size_t i = 0; i < words.size(); ++i) out.push_back(dp::ci_string(words[i].data(), words[i].size()));
+			return out;
+		}();
+		return keys;
+	}
+	const std::vector<dp::ci_string>& dictionary_lookups(bool present) {
+		static const std::vector<dp::ci_string> hits = [] {
+			data::rng gen(10);
+			std::vector<dp::ci_string> out = dictionary_keys();
+			for (std::size_t i = 0; i < out.size(); ++i) {
+				for (std::size_t j = 0; j < out[i].size(); ++j) {
+					if (gen.below(2) == 0) out[i][j] = static_cast<char>(out[i][j] - 'a' + 'A');
+				}
+			}
+			return out;
+		}();
+		static const std::vector<dp::ci_string> misses = [] {
+			std::vector<dp::ci_string> out = dictionary_keys();
+			for (std::size_t i = 0; i < out.size(); ++i) out[i] += '#';
+			return out;
+		}();
+		return present ? hits : misses;
+	}
+
+	template<typename Map>
+	void map_insert(state& st) {
+		const std::vector<dp::ci_string>& keys = dictionary_keys();
+		st.set_items_per_iteration(keys.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			Map map;
+			for (std::size_t i = 0; i < keys.size(); ++i) map.try_emplace(keys[i], static_cast<int>(i));
+			dp_bench::do_not_optimize(map.size());
+		}
+	}
+
+	template<typename Map>
+	void map_find(state& st, bool present) {
+		const std::vector<dp::ci_string>& keys = dictionary_keys();
+		const std::vector<dp::ci_string>& lookups = dictionary_lookups(present);
+		Map map;
+		for (std::size_t i = 0; i < keys.size(); ++i) map.try_emplace(keys[i], static_cast<int>(i));
+		st.set_items_per_iteration(lookups.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < lookups.size(); ++i) {
+				dp_bench::do_not_optimize(map.find(lookups[i]) != map.end());
+			}
+		}
+	}
+
+	const std::vector<std::string>& narrow_short() {
+		static const std::vector<std::string> text = mixed_case_text<char>(12, 1, false);
+		return text;
+	}
+	const std::vector<std::string>& narrow_long() {
+		static const std::vector<std::string> text = mixed_case_text<char>(256, 2, false);
+		return text;
+	}
+	const std::vector<std::wstring>& wide_ascii() {
+		static const std::vector<std::wstring> text = mixed_case_text<wchar_t>(64, 3, false);
+		return text;
+	}
+	const std::vector<std::wstring>& wide_latin1() {
+		static const std::vector<std::wstring> text = mixed_case_text<wchar_t>(64, 4, true);
+		return text;
+	}
+
+	//Per character, rather than per string. There is no legacy run for Latin-1, as outside a suitable locale towupper doesn't fold it at all
+	void compare_narrow_short(state& st) { compare_pairs<dp::ci_char_traits>(st, narrow_short()); }
+	void compare_narrow_short_legacy(state& st) { compare_pairs<legacy_ci_traits<char> >(st, narrow_short()); }
+	void compare_narrow_long(state& st) { compare_pairs<dp::ci_char_traits>(st, narrow_long()); }
+	void compare_narrow_long_legacy(state& st) { compare_pairs<legacy_ci_traits<char> >(st, narrow_long()); }
+	void compare_wide_ascii(state& st) { compare_pairs<dp::ci_wchar_traits>(st, wide_ascii()); }
+	void compare_wide_ascii_legacy(state& st) { compare_pairs<legacy_ci_traits<wchar_t> >(st, wide_ascii()); }
+	void compare_wide_latin1(state& st) { compare_pairs<dp::ci_wchar_traits>(st, wide_latin1()); }
+	void find_narrow_long(state& st) { find_missing<dp::ci_char_traits>(st, narrow_long()); }
+	void find_narrow_long_legacy(state& st) { find_missing<legacy_ci_traits<char> >(st, narrow_long()); }
+	void find_wide_ascii(state& st) { find_missing<dp::ci_wchar_traits>(st, wide_ascii()); }
+	void find_wide_ascii_legacy(state& st) { find_missing<legacy_ci_traits<wchar_t> >(st, wide_ascii()); }
+
+	//Comparing ordinary strings ignoring case, by way of an owning copy or a view with the case-insensitive traits
+	template<bool View>
+	void compare_cast(state& st) {
+		const std::vector<std::string>& input = narrow_short();
+		st.set_items_per_iteration(input.size() / 2);
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i + 1 < input.size(); i += 2) {
+				if (View) dp_bench::do_not_optimize(dp::traits_view<dp::ci_char_traits>(input[i]) == dp::traits_view<dp::ci_char_traits>(input[i + 1]));
+				else dp_bench::do_not_optimize(dp::traits_cast<dp::ci_char_traits>(input[i]) == dp::traits_cast<dp::ci_char_traits>(input[i + 1]));
+			}
+		}
+	}
+
+	//Hashing and lookup are per string, rather than per character
+	void hash_narrow_short(state& st) { hash_all<dp::ci_hash>(st, narrow_short()); }
+	void hash_narrow_short_legacy(state& st) { hash_all<legacy_ci_hash>(st, narrow_short()); }
+	void hash_narrow_long(state& st) { hash_all<dp::ci_hash>(st, narrow_long()); }
+	void hash_narrow_long_legacy(state& st) { hash_all<legacy_ci_hash>(st, narrow_long()); }
+	void lookup_narrow_short(state& st) { lookup_all<dp::ci_unordered_set<> >(st, narrow_short()); }
+	void lookup_narrow_short_legacy(state& st) { lookup_all<std::unordered_set<dp::ci_string, legacy_ci_hash> >(st, narrow_short()); }
+
+	void compare_traits_view(state& st) { compare_cast<true>(st); }
+	void compare_traits_cast(state& st) { compare_cast<false>(st); }
+
+	//Both maps hash with ci_hash, so these compare only the containers
+	using flat_map = dp::ci_flat_map<int>;
+	using node_map = std::unordered_map<dp::ci_string, int>;
+	void flat_map_insert(state& st) { map_insert<flat_map>(st); }
+	void node_map_insert(state& st) { map_insert<node_map>(st); }
+	void flat_map_hit(state& st) { map_find<flat_map>(st, true); }
+	void node_map_hit(state& st) { map_find<node_map>(st, true); }
+	void flat_map_miss(state& st) { map_find<flat_map>(st, false); }
+	void node_map_miss(state& st) { map_find<node_map>(st, false); }
+
+	DP_BENCHMARK("ci_compare/narrow_12", compare_narrow_short);
+	DP_BENCHMARK("ci_compare/narrow_12/legacy", compare_narrow_short_legacy);
+	DP_BENCHMARK("ci_compare/narrow_256", compare_narrow_long);
+	DP_BENCHMARK("ci_compare/narrow_256/legacy", compare_narrow_long_legacy);
+	DP_BENCHMARK("ci_compare/wide_ascii_64", compare_wide_ascii);
+	DP_BENCHMARK("ci_compare/wide_ascii_64/legacy", compare_wide_ascii_legacy);
+	DP_BENCHMARK("ci_compare/wide_latin1_64", compare_wide_latin1);
+	DP_BENCHMARK("ci_find/narrow_256", find_narrow_long);
+	DP_BENCHMARK("ci_find/narrow_256/legacy", find_narrow_long_legacy);
+	DP_BENCHMARK("ci_find/wide_ascii_64", find_wide_ascii);
+	DP_BENCHMARK("ci_find/wide_ascii_64/legacy", find_wide_ascii_legacy);
+	DP_BENCHMARK("ci_hash/narrow_12", hash_narrow_short);
+	DP_BENCHMARK("ci_hash/narrow_12/legacy", hash_narrow_short_legacy);
+	DP_BENCHMARK("ci_hash/narrow_256", hash_narrow_long);
+	DP_BENCHMARK("ci_hash/narrow_256/legacy", hash_narrow_long_legacy);
+	DP_BENCHMARK("ci_unordered_set/count/narrow_12", lookup_narrow_short);
+	DP_BENCHMARK("ci_unordered_set/count/narrow_12/legacy", lookup_narrow_short_legacy);
+	DP_BENCHMARK("traits_view/compare_12", compare_traits_view);
+	DP_BENCHMARK("traits_view/compare_12/traits_cast", compare_traits_cast);
+	DP_BENCHMARK("ci_flat_map/insert", flat_map_insert);
+	DP_BENCHMARK("ci_flat_map/insert/unordered_map", node_map_insert);
+	DP_BENCHMARK("ci_flat_map/find_hit", flat_map_hit);
+	DP_BENCHMARK("ci_flat_map/find_hit/unordered_map", node_map_hit);
+	DP_BENCHMARK("ci_flat_map/find_miss", flat_map_miss);
+	DP_BENCHMARK("ci_flat_map/find_miss/unordered_map", node_map_miss);
+
+}
+
+int main(int argc, char** argv) {
+	return dp_bench::run(argc, argv, DP_BENCH_VARIANT);
+}
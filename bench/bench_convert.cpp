@@ -0,0 +1,549 @@
+/*
+*  Benchmarks for convert_to, covering every family of source and destination type.
+*  This file is built twice: as dp_bench against the C++17 header, and as dp_bench_cpp98 against the C++98 header.
+*  Benchmarks share a name across both so the two sets of results can be diffed directly; those the C++98 header has no equivalent for
+*  are only built into dp_bench. The baseline/ benchmarks time the standard library doing the same job, for scale.
+*/
+
+#include "convert.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <string>
+#include <vector>
+#include <sstream>
+
+#ifdef DP_CPP17_CONVERT_TO
+#include <string_view>
+#include <array>
+#include <thread>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include "mapped_file.h"
+#endif
+
+#include "bench_harness.h"
+#include "bench_data.h"
+
+#ifndef DP_BENCH_VARIANT
+#define DP_BENCH_VARIANT "unknown"
+#endif
+
+namespace {
+
+	using dp_bench::state;
+	namespace data = dp_bench::data;
+
+	template<typename To, typename From>
+	void convert_each(state& st, const std::vector<From>& input) {
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < input.size(); ++i) dp_bench::do_not_optimize(dp::convert_to<To>(input[i]));
+		}
+	}
+
+	//Inputs are function statics, so they are built on the harness's untimed first call
+	const std::vector<long long>& small_integers() {
+		static const std::vector<long long> values = data::small_integers();
+		return values;
+	}
+
+	const std::vector<long long>& full_integers() {
+		static const std::vector<long long> values = data::full_integers();
+		return values;
+	}
+
+	const std::vector<double>& prices() {
+		static const std::vector<double> values = data::prices();
+		return values;
+	}
+
+	const std::vector<double>& measurements() {
+		static const std::vector<double> values = data::measurements();
+		return values;
+	}
+
+
+	//STRING TO INTEGER
+	void string_to_int_small(state& st) {
+		static const std::vector<std::string> input = data::integer_strings(small_integers());
+		convert_each<long long>(st, input);
+	}
+	DP_BENCHMARK("string_to_int/small", string_to_int_small);
+
+	void string_to_int_int64(state& st) {
+		static const std::vector<std::string> input = data::integer_strings(full_integers());
+		convert_each<long long>(st, input);
+	}
+	DP_BENCHMARK("string_to_int/int64", string_to_int_int64);
+
+	void string_to_int_hex(state& st) {
+		static const std::vector<std::string> input = data::hex_strings(full_integers());
+		convert_each<long long>(st, input);
+	}
+	DP_BENCHMARK("string_to_int/hex", string_to_int_hex);
+
+	void baseline_strtoll(state& st) {
+		static const std::vector<std::string> input = data::integer_strings(full_integers());
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < input.size(); ++i) dp_bench::do_not_optimize(std::strtoll(input[i].c_str(), NULL, 10));
+		}
+	}
+	DP_BENCHMARK("baseline/strtoll_int64", baseline_strtoll);
+
+
+	//STRING TO FLOATING POINT
+	void string_to_double_prices(state& st) {
+		static const std::vector<std::string> input = data::price_strings(prices());
+		convert_each<double>(st, input);
+	}
+	DP_BENCHMARK("string_to_double/prices", string_to_double_prices);
+
+	void string_to_double_precise(state& st) {
+		static const std::vector<std::string> input = data::precise_strings(measurements());
+		convert_each<double>(st, input);
+	}
+	DP_BENCHMARK("string_to_double/precise", string_to_double_precise);
+
+	void baseline_strtod(state& st) {
+		static const std::vector<std::string> input = data::precise_strings(measurements());
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < input.size(); ++i) dp_bench::do_not_optimize(std::strtod(input[i].c_str(), NULL));
+		}
+	}
+	DP_BENCHMARK("baseline/strtod_precise", baseline_strtod);
+
+
+	//INTEGER TO STRING
+	//Most small values fit in the small string buffer, so these mostly time formatting. The 64-bit values mostly time allocation.
+	void int_to_string_small(state& st) {
+		convert_each<std::string>(st, small_integers());
+	}
+	DP_BENCHMARK("int_to_string/small", int_to_string_small);
+
+	void int_to_string_int64(state& st) {
+		convert_each<std::string>(st, full_integers());
+	}
+	DP_BENCHMARK("int_to_string/int64", int_to_string_int64);
+
+	void int_to_wstring_small(state& st) {
+		convert_each<std::wstring>(st, small_integers());
+	}
+	DP_BENCHMARK("int_to_wstring/small", int_to_wstring_small);
+
+	void int_to_wstring_int64(state& st) {
+		convert_each<std::wstring>(st, full_integers());
+	}
+	DP_BENCHMARK("int_to_wstring/int64", int_to_wstring_int64);
+
+	void baseline_to_string(state& st) {
+		const std::vector<long long>& input = full_integers();
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < input.size(); ++i) dp_bench::do_not_optimize(std::to_string(input[i]));
+		}
+	}
+	DP_BENCHMARK("baseline/to_string_int64", baseline_to_string);
+
+	void baseline_to_wstring(state& st) {
+		const std::vector<long long>& input = full_integers();
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < input.size(); ++i) dp_bench::do_not_optimize(std::to_wstring(input[i]));
+		}
+	}
+	DP_BENCHMARK("baseline/to_wstring_int64", baseline_to_wstring);
+
+	//How the C++98 headers formatted numbers before they had their own formatters
+	void baseline_stringstream_int64(state& st) {
+		const std::vector<long long>& input = full_integers();
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < input.size(); ++i) {
+				std::stringstream ss;
+				ss << input[i];
+				dp_bench::do_not_optimize(ss.str());
+			}
+		}
+	}
+	DP_BENCHMARK("baseline/stringstream_int64", baseline_stringstream_int64);
+
+
+	//FLOATING POINT TO STRING
+	void double_to_string_prices(state& st) {
+		convert_each<std::string>(st, prices());
+	}
+	DP_BENCHMARK("double_to_string/prices", double_to_string_prices);
+
+	void double_to_string_precise(state& st) {
+		convert_each<std::string>(st, measurements());
+	}
+	DP_BENCHMARK("double_to_string/precise", double_to_string_precise);
+
+	void double_to_wstring_precise(state& st) {
+		convert_each<std::wstring>(st, measurements());
+	}
+	DP_BENCHMARK("double_to_wstring/precise", double_to_wstring_precise);
+
+	void baseline_snprintf_fixed2(state& st) {
+		const std::vector<double>& input = prices();
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < input.size(); ++i) {
+				char buffer[32];
+				const int length = std::snprintf(buffer, sizeof(buffer), "%.2f", input[i]);
+				dp_bench::do_not_optimize(std::string(buffer, static_cast<std::size_t>(length)));
+			}
+		}
+	}
+	DP_BENCHMARK("baseline/snprintf_fixed2", baseline_snprintf_fixed2);
+
+	//Only six significant digits, so this doesn't round-trip; but it is what double_to_string/precise replaced in the C++98 headers
+	void baseline_stringstream_precise(state& st) {
+		const std::vector<double>& input = measurements();
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < input.size(); ++i) {
+				std::stringstream ss;
+				ss << input[i];
+				dp_bench::do_not_optimize(ss.str());
+			}
+		}
+	}
+	DP_BENCHMARK("baseline/stringstream_precise", baseline_stringstream_precise);
+
+
+	//BOOL AND NUMERIC
+	void bool_to_string(state& st) {
+		static const std::vector<bool> input = data::booleans();
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (std::size_t i = 0; i < input.size(); ++i) dp_bench::do_not_optimize(dp::convert_to<std::string>(static_cast<bool>(input[i])));
+		}
+	}
+	DP_BENCHMARK("bool_to_string", bool_to_string);
+
+	void int_to_double(state& st) {
+		convert_each<double>(st, full_integers());
+	}
+	DP_BENCHMARK("int_to_double", int_to_double);
+
+	void double_to_int(state& st) {
+		convert_each<long long>(st, prices());
+	}
+	DP_BENCHMARK("double_to_int", double_to_int);
+
+
+#ifdef DP_CPP17_CONVERT_TO
+
+	//From here on, conversions only the C++17 header supports
+
+	void wstring_to_int_small(state& st) {
+		static const std::vector<std::wstring> input = data::widen(data::integer_strings(small_integers()));
+		convert_each<long long>(st, input);
+	}
+	DP_BENCHMARK("wstring_to_int/small", wstring_to_int_small);
+
+	void baseline_wcstoll(state& st) {
+		static const std::vector<std::wstring> input = data::widen(data::integer_strings(small_integers()));
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (const auto& in : input) dp_bench::do_not_optimize(std::wcstoll(in.c_str(), nullptr, 10));
+		}
+	}
+	DP_BENCHMARK("baseline/wcstoll_small", baseline_wcstoll);
+
+	void wstring_to_double_prices(state& st) {
+		static const std::vector<std::wstring> input = data::widen(data::price_strings(prices()));
+		convert_each<double>(st, input);
+	}
+	DP_BENCHMARK("wstring_to_double/prices", wstring_to_double_prices);
+
+	void baseline_wcstod(state& st) {
+		static const std::vector<std::wstring> input = data::widen(data::price_strings(prices()));
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (const auto& in : input) dp_bench::do_not_optimize(std::wcstod(in.c_str(), nullptr));
+		}
+	}
+	DP_BENCHMARK("baseline/wcstod_prices", baseline_wcstod);
+
+	//string_views into a single buffer, as field_parser and mapped_file hand out
+	void string_view_to_int_small(state& st) {
+		static const std::vector<std::string> storage = data::integer_strings(small_integers());
+		static const std::vector<std::string_view> input(storage.begin(), storage.end());
+		convert_each<long long>(st, input);
+	}
+	DP_BENCHMARK("string_view_to_int/small", string_view_to_int_small);
+
+	void try_string_to_int_invalid(state& st) {
+		static const std::vector<std::string> input = data::mostly_integer_strings();
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (const auto& in : input) dp_bench::do_not_optimize(dp::try_convert_to<long long>(in).value_or(0));
+		}
+	}
+	DP_BENCHMARK("try_string_to_int/10pct_invalid", try_string_to_int_invalid);
+
+	void string_to_bool(state& st) {
+		static const std::vector<std::string> input = data::bool_strings();
+		convert_each<bool>(st, input);
+	}
+	DP_BENCHMARK("string_to_bool", string_to_bool);
+
+	void wstring_to_bool(state& st) {
+		static const std::vector<std::wstring> input = data::widen(data::bool_strings());
+		convert_each<bool>(st, input);
+	}
+	DP_BENCHMARK("wstring_to_bool", wstring_to_bool);
+
+	void double_to_string_fixed2(state& st) {
+		const auto& input{ prices() };
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			for (const auto in : input) dp_bench::do_not_optimize(dp::convert_to<std::string>(in, dp::fmt::fixed{ 2 }));
+		}
+	}
+	DP_BENCHMARK("double_to_string/fixed2", double_to_string_fixed2);
+
+	//Reusing one buffer, as a report writer would
+	void append_to_int64(state& st) {
+		const auto& input{ full_integers() };
+		st.set_items_per_iteration(input.size());
+		std::string buffer;
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			buffer.clear();
+			for (const auto in : input) {
+				dp::append_to(buffer, in);
+				buffer += ',';
+			}
+			dp_bench::do_not_optimize(buffer);
+		}
+	}
+	DP_BENCHMARK("append_to/int64", append_to_int64);
+
+
+	//NARROW AND WIDE STRINGS
+	void wstring_to_string_ascii(state& st) {
+		static const std::vector<std::wstring> input = data::widen(data::ascii_text());
+		convert_each<std::string>(st, input);
+	}
+	DP_BENCHMARK("wstring_to_string/ascii", wstring_to_string_ascii);
+
+	void string_to_wstring_ascii(state& st) {
+		static const std::vector<std::string> input = data::ascii_text();
+		convert_each<std::wstring>(st, input);
+	}
+	DP_BENCHMARK("string_to_wstring/ascii", string_to_wstring_ascii);
+
+	void string_to_wstring_multilingual(state& st) {
+		static const std::vector<std::string> input = data::multilingual_text();
+		convert_each<std::wstring>(st, input);
+	}
+	DP_BENCHMARK("string_to_wstring/multilingual", string_to_wstring_multilingual);
+
+	std::vector<std::wstring> wide_multilingual_text() {
+		std::vector<std::wstring> out;
+		for (const auto& in : data::multilingual_text()) out.push_back(dp::convert_to<std::wstring>(in));
+		return out;
+	}
+
+	void wstring_to_string_multilingual(state& st) {
+		static const std::vector<std::wstring> input = wide_multilingual_text();
+		convert_each<std::string>(st, input);
+	}
+	DP_BENCHMARK("wstring_to_string/multilingual", wstring_to_string_multilingual);
+
+
+	//BULK
+	void convert_range_int64(state& st) {
+		static const std::vector<std::string> input = data::integer_strings(full_integers());
+		std::vector<long long> out(input.size());
+		dp::error_bitmap errors;
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			dp_bench::do_not_optimize(dp::convert_range<long long>(input, out, errors));
+		}
+	}
+	DP_BENCHMARK("convert_range/int64", convert_range_int64);
+
+	//Large enough for the threads to be worth starting
+	const std::vector<std::string>& parallel_input() {
+		static const std::vector<std::string> input = [] {
+			const auto batch{ data::integer_strings(full_integers()) };
+			std::vector<std::string> out;
+			for (int copy = 0; copy < 64; ++copy) out.insert(out.end(), batch.begin(), batch.end());
+			return out;
+		}();
+		return input;
+	}
+
+	void convert_range_parallel(state& st, dp::parallel_policy policy) {
+		const auto& input{ parallel_input() };
+		std::vector<long long> out(input.size());
+		dp::error_bitmap errors;
+		st.set_items_per_iteration(input.size());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			dp_bench::do_not_optimize(dp::convert_range<long long>(policy, input, out, errors));
+		}
+	}
+
+	void convert_range_parallel_int64(state& st) {
+		convert_range_parallel(st, dp::parallel);
+	}
+	DP_BENCHMARK("convert_range_parallel/int64", convert_range_parallel_int64);
+
+	template<unsigned int Threads>
+	void convert_range_parallel_threads(state& st) {
+		convert_range_parallel(st, dp::parallel_policy{ Threads });
+	}
+
+	//The same run on 1, 2, 4, ... threads up to the hardware's own count, to show how it scales
+	const bool convert_range_parallel_scaling = [] {
+		const dp_bench::benchmark runs[]{
+			{ "convert_range_parallel/int64/threads:1", convert_range_parallel_threads<1> },
+			{ "convert_range_parallel/int64/threads:2", convert_range_parallel_threads<2> },
+			{ "convert_range_parallel/int64/threads:4", convert_range_parallel_threads<4> },
+			{ "convert_range_parallel/int64/threads:8", convert_range_parallel_threads<8> },
+			{ "convert_range_parallel/int64/threads:16", convert_range_parallel_threads<16> },
+			{ "convert_range_parallel/int64/threads:32", convert_range_parallel_threads<32> },
+			{ "convert_range_parallel/int64/threads:64", convert_range_parallel_threads<64> },
+			{ "convert_range_parallel/int64/threads:128", convert_range_parallel_threads<128> },
+			{ "convert_range_parallel/int64/threads:256", convert_range_parallel_threads<256> }
+		};
+		const unsigned int hardware{ std::thread::hardware_concurrency() };
+		for (std::size_t i = 0; i < std::size(runs) && (1u << i) <= (std::max)(hardware, 1u); ++i) dp_bench::registry().push_back(runs[i]);
+		return true;
+	}();
+
+
+
+	//FILES
+	//A numeric CSV of id, price and measurement, written to the temp directory on first use and removed at exit
+	class csv_file {
+		std::string file_path;
+		std::size_t row_count{ 0 };
+
+	public:
+		csv_file() : file_path{ (std::filesystem::temp_directory_path() / "dp_bench_convert.csv").string() } {
+			const auto ids{ data::integer_strings(full_integers()) };
+			const auto price_text{ data::price_strings(prices()) };
+			const auto measurement_text{ data::precise_strings(measurements()) };
+			std::ofstream out{ file_path, std::ios::binary };
+			for (int copy = 0; copy < 64; ++copy) {
+				for (std::size_t i = 0; i < ids.size(); ++i, ++row_count) out << ids[i] << ',' << price_text[i] << ',' << measurement_text[i] << '\n';
+			}
+		}
+		~csv_file() {
+			std::error_code ignored;
+			std::filesystem::remove(file_path, ignored);
+		}
+		csv_file(const csv_file&) = delete;
+		csv_file& operator=(const csv_file&) = delete;
+
+		const std::string& path() const {
+			return file_path;
+		}
+
+		std::size_t rows() const {
+			return row_count;
+		}
+	};
+
+	const csv_file& numeric_csv() {
+		static const csv_file file;
+		return file;
+	}
+
+	//Both readers split and convert each line the same way, so only the reading differs
+	struct csv_totals {
+		long long ids{ 0 };
+		double amounts{ 0 };
+	};
+
+	void parse_csv_line(std::string_view line, csv_totals& totals) {
+		const auto first_comma{ line.find(',') };
+		const auto second_comma{ line.find(',', first_comma + 1) };
+		totals.ids += dp::try_convert_to<long long>(line.substr(0, first_comma)).value_or(0);
+		totals.amounts += dp::try_convert_to<double>(line.substr(first_comma + 1, second_comma - first_comma - 1)).value_or(0);
+		totals.amounts += dp::try_convert_to<double>(line.substr(second_comma + 1)).value_or(0);
+	}
+
+	void csv_mapped_file(state& st) {
+		const auto& csv{ numeric_csv() };
+		st.set_items_per_iteration(csv.rows());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			const dp::mapped_file file{ csv.path() };
+			csv_totals totals;
+			for (const auto line : file.lines()) parse_csv_line(line, totals);
+			dp_bench::do_not_optimize(totals);
+		}
+	}
+	DP_BENCHMARK("read_csv/mapped_file", csv_mapped_file);
+
+	void baseline_csv_getline(state& st) {
+		const auto& csv{ numeric_csv() };
+		st.set_items_per_iteration(csv.rows());
+		for (std::size_t iteration = 0; iteration < st.iterations(); ++iteration) {
+			std::ifstream file{ csv.path(), std::ios::binary };
+			csv_totals totals;
+			for (std::string line; std::getline(file, line);) parse_csv_line(line, totals);
+			dp_bench::do_not_optimize(totals);
+		}
+	}
+	DP_BENCHMARK("baseline/read_csv_getline", baseline_csv_getline);
+
+#endif
+
+}
+
+#ifdef DP_CPP17_CONVERT_TO
+
+//ENUMS
+enum class bench_level { trace, debug, info, notice, warning, error, critical, alert, emergency };
+
+template<>
+struct dp::enum_names<bench_level> {
+	static constexpr dp::enum_entry<bench_level> entries[]{ { "trace", bench_level::trace }, { "debug", bench_level::debug }, { "info", bench_level::info },
+		{ "notice", bench_level::notice }, { "warning", bench_level::warning }, { "error", bench_level::error }, { "critical", bench_level::critical },
+		{ "alert", bench_level::alert }, { "emergency", bench_level::emergency } };
+};
+
+namespace {
+
+	std::vector<std::string> level_names() {
+		dp_bench::data::rng gen(10);
+		std::vector<std::string> out;
+		for (std::size_t i = 0; i < dp_bench::data::batch_size; ++i) {
+			out.emplace_back(dp::enum_names<bench_level>::entries[gen.below(std::size(dp::enum_names<bench_level>::entries))].name);
+		}
+		return out;
+	}
+
+	void string_to_enum(dp_bench::state& st) {
+		static const std::vector<std::string> input = level_names();
+		convert_each<bench_level>(st, input);
+	}
+	DP_BENCHMARK("string_to_enum", string_to_enum);
+
+	void enum_to_string_view(dp_bench::state& st) {
+		static const std::vector<bench_level> input = [] {
+			std::vector<bench_level> out;
+			for (const auto& name : level_names()) out.push_back(dp::convert_to<bench_level>(name));
+			return out;
+		}();
+		convert_each<std::string_view>(st, input);
+	}
+	DP_BENCHMARK("enum_to_string_view", enum_to_string_view);
+
+}
+
+#endif
+
+int main(int argc, char** argv) {
+	return dp_bench::run(argc, argv, DP_BENCH_VARIANT);
+}
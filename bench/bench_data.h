@@ -0,0 +1,184 @@
+#ifndef DP_BENCH_DATA
+#define DP_BENCH_DATA
+
+/*
+*  Input data for the benchmarks. Every set is generated from a fixed seed, so runs on different builds see exactly the same input.
+*  The distributions are meant to look like real data rather than uniformly random bits: most integers in a file are small,
+*  most decimals are prices or measurements with a couple of places, and booleans come in whatever case the author felt like.
+*/
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace dp_bench {
+	namespace data {
+
+		//Enough items per iteration to amortise the loop, while the input still fits comfortably in cache
+		static const std::size_t batch_size = 4096;
+
+		//xorshift64*. Not the std <random> engines, as their distributions are allowed to differ between standard libraries.
+		class rng {
+			unsigned long long val;
+
+		public:
+			explicit rng(unsigned long long seed) : val(seed) {}
+
+			unsigned long long next() {
+				val ^= val >> 12;
+				val ^= val << 25;
+				val ^= val >> 27;
+				return val * 0x2545F4914F6CDD1Dull;
+			}
+
+			//Uniform in [0, bound)
+			unsigned long long below(unsigned long long bound) {
+				return next() % bound;
+			}
+		};
+
+		//Between one and six digits, with each length equally likely, and one in ten negative
+		inline std::vector<long long> small_integers() {
+			rng gen(1);
+			std::vector<long long> out;
+			static const long long limits[] = { 10, 100, 1000, 10000, 100000, 1000000 };
+			for (std::size_t i = 0; i < batch_size; ++i) {
+				const long long value = static_cast<long long>(gen.below(static_cast<unsigned long long>(limits[gen.below(6)])));
+				out.push_back(gen.below(10) == 0 ? -value : value);
+			}
+			return out;
+		}
+
+		//Any 64-bit value, so mostly 19 or 20 characters
+		inline std::vector<long long> full_integers() {
+			rng gen(2);
+			std::vector<long long> out;
+			for (std::size_t i = 0; i < batch_size; ++i) out.push_back(static_cast<long long>(gen.next()));
+			return out;
+		}
+
+		//Amounts of money, up to a million with two decimal places
+		inline std::vector<double> prices() {
+			rng gen(3);
+			std::vector<double> out;
+			for (std::size_t i = 0; i < batch_size; ++i) out.push_back(static_cast<double>(gen.below(100000000)) / 100);
+			return out;
+		}
+
+		//Full precision values spread evenly over twenty orders of magnitude
+		inline std::vector<double> measurements() {
+			rng gen(4);
+			std::vector<double> out;
+			for (std::size_t i = 0; i < batch_size; ++i) {
+				double value = static_cast<double>(gen.next() >> 11) / 9007199254740992.0;
+				for (unsigned long long exp = gen.below(20); exp != 0; --exp) value *= 10;
+				out.push_back(value * 1e-10);
+			}
+			return out;
+		}
+
+		inline std::vector<bool> booleans() {
+			rng gen(5);
+			std::vector<bool> out;
+			for (std::size_t i = 0; i < batch_size; ++i) out.push_back(gen.below(2) == 0);
+			return out;
+		}
+
+		inline std::vector<std::string> integer_strings(const std::vector<long long>& values) {
+			std::vector<std::string> out;
+			char buffer[32];
+			for (std::size_t i = 0; i < values.size(); ++i) {
+				std::sprintf(buffer, "%lld", values[i]);
+				out.push_back(buffer);
+			}
+			return out;
+		}
+
+		inline std::vector<std::string> hex_strings(const std::vector<long long>& values) {
+			std::vector<std::string> out;
+			char buffer[32];
+			for (std::size_t i = 0; i < values.size(); ++i) {
+				std::sprintf(buffer, "0x%llX", static_cast<unsigned long long>(values[i]) >> 1);
+				out.push_back(buffer);
+			}
+			return out;
+		}
+
+		//Prices as they would be written, with exactly two places
+		inline std::vector<std::string> price_strings(const std::vector<double>& values) {
+			std::vector<std::string> out;
+			char buffer[32];
+			for (std::size_t i = 0; i < values.size(); ++i) {
+				std::sprintf(buffer, "%.2f", values[i]);
+				out.push_back(buffer);
+			}
+			return out;
+		}
+
+		//Enough digits to round-trip
+		inline std::vector<std::string> precise_strings(const std::vector<double>& values) {
+			std::vector<std::string> out;
+			char buffer[32];
+			for (std::size_t i = 0; i < values.size(); ++i) {
+				std::sprintf(buffer, "%.17g", values[i]);
+				out.push_back(buffer);
+			}
+			return out;
+		}
+
+		inline std::vector<std::string> bool_strings() {
+			rng gen(6);
+			static const char* const words[] = { "true", "false", "True", "False", "TRUE", "FALSE", "yes", "no", "Yes", "No", "1", "0" };
+			std::vector<std::string> out;
+			for (std::size_t i = 0; i < batch_size; ++i) out.push_back(words[gen.below(sizeof(words) / sizeof(words[0]))]);
+			return out;
+		}
+
+		//One in ten entries is not a number, as in a column with the odd blank or "N/A"
+		inline std::vector<std::string> mostly_integer_strings() {
+			rng gen(7);
+			std::vector<std::string> out = integer_strings(small_integers());
+			static const char* const junk[] = { "", "N/A", "-", "12a", "?" };
+			for (std::size_t i = 0; i < out.size(); ++i) {
+				if (gen.below(10) == 0) out[i] = junk[gen.below(5)];
+			}
+			return out;
+		}
+
+		//Words of a few characters to a few tens, as in labels or column headers
+		inline std::vector<std::string> ascii_text() {
+			rng gen(8);
+			std::vector<std::string> out;
+			for (std::size_t i = 0; i < batch_size; ++i) {
+				std::string word;
+				for (unsigned long long length = 3 + gen.below(30); length != 0; --length) word += static_cast<char>('a' + gen.below(26));
+				out.push_back(word);
+			}
+			return out;
+		}
+
+		//As above, but in UTF-8 with a mix of Latin-1, Greek, CJK and the odd emoji
+		inline std::vector<std::string> multilingual_text() {
+			rng gen(9);
+			static const char* const pieces[] = { "a", "e", "\xC3\xA9", "\xC3\xBC", "\xCE\xB1", "\xCE\xA9", "\xE4\xB8\xAD", "\xE6\x96\x87", "\xF0\x9F\x98\x80", " " };
+			std::vector<std::string> out;
+			for (std::size_t i = 0; i < batch_size; ++i) {
+				std::string word;
+				for (unsigned long long length = 3 + gen.below(20); length != 0; --length) word += pieces[gen.below(10)];
+				out.push_back(word);
+			}
+			return out;
+		}
+
+		//Only correct for ASCII, which is all that number and boolean text ever holds
+		inline std::vector<std::wstring> widen(const std::vector<std::string>& in) {
+			std::vector<std::wstring> out;
+			for (std::size_t i = 0; i < in.size(); ++i) out.push_back(std::wstring(in[i].begin(), in[i].end()));
+			return out;
+		}
+
+	}
+}
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef DP_BENCH_HARNESS
+#define DP_BENCH_HARNESS
+
+/*
+*  A minimal benchmark harness, so the benchmarks build anywhere the library does without pulling in a third-party framework.
+*  Each benchmark runs its body for a number of iterations chosen by the harness, and reports the time per iteration along with
+*  the items processed per second, as Google Benchmark does.
+*  Results go to the console, or as JSON in the same layout as Google Benchmark's --benchmark_format=json so existing tools can diff them.
+*
+*  Usage: dp_bench [--filter=substring] [--min-time=seconds] [--repetitions=n] [--json[=file]]
+*
+*  Only C++11 is required, as the same benchmarks are built against both the C++17 and C++98 convert_to headers.
+*/
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace dp_bench {
+
+	class state {
+		std::size_t iteration_count;
+		std::size_t items{ 1 };
+
+	public:
+		explicit state(std::size_t in_iterations) : iteration_count{ in_iterations } {}
+
+		std::size_t iterations() const {
+			return iteration_count;
+		}
+
+		//The number of items each iteration processes, so results can be reported per item
+		void set_items_per_iteration(std::size_t in_items) {
+			items = in_items;
+		}
+
+		std::size_t items_per_iteration() const {
+			return items;
+		}
+	};
+
+	typedef void (*benchmark_function)(state&);
+
+	struct benchmark {
+		const char* name;
+		benchmark_function function;
+	};
+
+	inline std::vector<benchmark>& registry() {
+		static std::vector<benchmark> benchmarks;
+		return benchmarks;
+	}
+
+	struct registrar {
+		registrar(const char* name, benchmark_function function) {
+			benchmark entry = { name, function };
+			registry().push_back(entry);
+		}
+	};
+
+	//Keeps the compiler from discarding a result which is never used
+	template<typename T>
+	inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static const void* volatile sink;
+		sink = &value;
+#endif
+	}
+
+	//Times are per iteration; an iteration may process several items
+	struct result {
+		std::string name;
+		std::size_t iterations;
+		double real_ns;
+		double cpu_ns;
+		double items_per_second;
+	};
+
+	struct options {
+		std::string filter;
+		double min_time{ 0.5 };
+		std::size_t repetitions{ 3 };
+		bool json{ false };
+		std::string json_file;
+	};
+
+	struct measurement {
+		double real_seconds;
+		double cpu_seconds;
+		std::size_t items;
+	};
+
+	inline measurement measure(benchmark_function function, std::size_t iterations) {
+		state st(iterations);
+		const std::clock_t cpu_start = std::clock();
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		function(st);
+		const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		const std::clock_t cpu_end = std::clock();
+		measurement out = { std::chrono::duration<double>(end - start).count(), static_cast<double>(cpu_end - cpu_start) / CLOCKS_PER_SEC,
+			iterations * st.items_per_iteration() };
+		return out;
+	}
+
+	//Grows the iteration count until a run takes long enough to time reliably, then takes the median of the repetitions
+	inline result run_one(const benchmark& bench, const options& opts) {
+		//The first call also builds any input data the benchmark keeps, so it is never timed
+		measure(bench.function, 1);
+
+		std::size_t iterations = 1;
+		measurement trial = measure(bench.function, iterations);
+		while (trial.real_seconds < opts.min_time / 10 && iterations < (std::size_t(1) << 30)) {
+			iterations *= trial.real_seconds < opts.min_time / 1000 ? 100 : 10;
+			trial = measure(bench.function, iterations);
+		}
+		if (trial.real_seconds < opts.min_time) {
+			const double scale = opts.min_time / std::max(trial.real_seconds, 1e-9);
+			iterations = std::max<std::size_t>(iterations, static_cast<std::size_t>(iterations * scale));
+		}
+
+		std::vector<measurement> runs;
+		for (std::size_t i = 0; i < std::max<std::size_t>(opts.repetitions, 1); ++i) runs.push_back(measure(bench.function, iterations));
+		std::sort(runs.begin(), runs.end(), [](const measurement& lhs, const measurement& rhs) { return lhs.real_seconds < rhs.real_seconds; });
+		const measurement& median = runs[runs.size() / 2];
+
+		result out;
+		out.name = bench.name;
+		out.iterations = iterations;
+		out.real_ns = median.real_seconds * 1e9 / static_cast<double>(iterations);
+		out.cpu_ns = median.cpu_seconds * 1e9 / static_cast<double>(iterations);
+		out.items_per_second = median.real_seconds > 0 ? static_cast<double>(median.items) / median.real_seconds : 0.0;
+		return out;
+	}
+
+	inline void write_json_string(std::FILE* out, const std::string& in) {
+		std::fputc('"', out);
+		for (std::size_t i = 0; i < in.size(); ++i) {
+			if (in[i] == '"' || in[i] == '\\') std::fputc('\\', out);
+			std::fputc(in[i], out);
+		}
+		std::fputc('"', out);
+	}
+
+	inline void write_json(std::FILE* out, const std::vector<result>& results, const char* variant) {
+		char date[64] = "";
+		const std::time_t now = std::time(NULL);
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+		std::fprintf(out, "{\n  \"context\": {\n    \"date\": ");
+		write_json_string(out, date);
+		std::fprintf(out, ",\n    \"library_variant\": ");
+		write_json_string(out, variant);
+		std::fprintf(out, ",\n    \"cplusplus\": %ld,\n    \"library_build_type\": \"%s\"\n  },\n  \"benchmarks\": [", static_cast<long>(__cplusplus),
+#ifdef NDEBUG
+			"release"
+#else
+			"debug"
+#endif
+		);
+		for (std::size_t i = 0; i < results.size(); ++i) {
+			std::fprintf(out, "%s\n    {\n      \"name\": ", i == 0 ? "" : ",");
+			write_json_string(out, results[i].name);
+			std::fprintf(out, ",\n      \"run_name\": ");
+			write_json_string(out, results[i].name);
+			std::fprintf(out, ",\n      \"run_type\": \"iteration\",\n      \"iterations\": %lu,\n      \"real_time\": %.4f,\n      \"cpu_time\": %.4f,\n"
+				"      \"time_unit\": \"ns\",\n      \"items_per_second\": %.1f\n    }",
+				static_cast<unsigned long>(results[i].iterations), results[i].real_ns, results[i].cpu_ns, results[i].items_per_second);
+		}
+		std::fprintf(out, "\n  ]\n}\n");
+	}
+
+	inline bool parse_options(int argc, char** argv, options& opts) {
+		for (int i = 1; i < argc; ++i) {
+			const std::string arg = argv[i];
+			if (arg.compare(0, 9, "--filter=") == 0) {
+				opts.filter = arg.substr(9);
+			}
+			else if (arg.compare(0, 11, "--min-time=") == 0) {
+				opts.min_time = std::atof(arg.c_str() + 11);
+			}
+			else if (arg.compare(0, 14, "--repetitions=") == 0) {
+				opts.repetitions = static_cast<std::size_t>(std::atoi(arg.c_str() + 14));
+			}
+			else if (arg == "--json") {
+				opts.json = true;
+			}
+			else if (arg.compare(0, 7, "--json=") == 0) {
+				opts.json = true;
+				opts.json_file = arg.substr(7);
+			}
+			else {
+				std::fprintf(stderr, "Usage: %s [--filter=substring] [--min-time=seconds] [--repetitions=n] [--json[=file]]\n", argv[0]);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	inline int run(int argc, char** argv, const char* variant) {
+		options opts;
+		if (!parse_options(argc, argv, opts)) return 1;
+
+		//With JSON going to stdout, the human-readable table goes nowhere
+		const bool table = !opts.json || !opts.json_file.empty();
+		if (table) std::printf("%-44s %14s %14s %16s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Items/s");
+
+		std::vector<result> results;
+		for (std::size_t i = 0; i < registry().size(); ++i) {
+			const benchmark& bench = registry()[i];
+			if (!opts.filter.empty() && std::string(bench.name).find(opts.filter) == std::string::npos) continue;
+			results.push_back(run_one(bench, opts));
+			if (table) {
+				const result& res = results.back();
+				std::printf("%-44s %14.2f %14.2f %16.0f\n", res.name.c_str(), res.real_ns, res.cpu_ns, res.items_per_second);
+				std::fflush(stdout);
+			}
+		}
+
+		if (opts.json) {
+			std::FILE* out = opts.json_file.empty() ? stdout : std::fopen(opts.json_file.c_str(), "w");
+			if (out == NULL) {
+				std::fprintf(stderr, "Could not open %s for writing\n", opts.json_file.c_str());
+				return 1;
+			}
+			write_json(out, results, variant);
+			if (out != stdout) std::fclose(out);
+		}
+		return 0;
+	}
+
+}
+
+#define DP_BENCH_CONCAT_IMPL(a, b) a##b
+#define DP_BENCH_CONCAT(a, b) DP_BENCH_CONCAT_IMPL(a, b)
+#define DP_BENCHMARK(name, function) static const dp_bench::registrar DP_BENCH_CONCAT(dp_bench_registrar_, __LINE__)(name, function)
+
+#endif
@@ -0,0 +1,893 @@
+#ifndef DP_CPP17_CHARCONV
+#define DP_CPP17_CHARCONV
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <cfloat>
+#include <limits>
+#include <type_traits>
+#include <array>
+#include <memory>
+#if defined(__has_include)
+#if __has_include(<bit>)
+#include <bit>
+#endif
+#endif
+
+#include "bits/charconv_tables_cpp17.h"
+
+/*
+*  Hand-written number parsing and formatting kernels for convert_to.
+*  These are drop-in replacements for std::from_chars and std::to_chars in the cases where we can beat the standard library, and so follow their
+*  semantics exactly: no leading whitespace or '+', the longest valid prefix is consumed, and on failure the output is left untouched.
+*
+*  Full documentation here: https://github.com/DryPerspective/C_Builder_Extras/wiki/Convert
+*/
+
+namespace dp {
+	namespace conv_impl {
+
+		/*
+		*  SWAR (SIMD within a register) decimal parsing. Rather than tie the library to a particular instruction set and
+		*  dispatch at runtime, we load eight characters into a 64-bit word and validate and accumulate them all at once.
+		*  This works on every platform C++Builder targets and compilers are happy to keep it all in registers.
+		*/
+		namespace swar {
+
+			inline std::uint64_t load_eight(const char* in) {
+				std::uint64_t val;
+				std::memcpy(&val, in, sizeof(val));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+				//The arithmetic below assumes the first character is in the lowest byte
+				val = ((val & 0x00000000FFFFFFFFull) << 32) | ((val & 0xFFFFFFFF00000000ull) >> 32);
+				val = ((val & 0x0000FFFF0000FFFFull) << 16) | ((val & 0xFFFF0000FFFF0000ull) >> 16);
+				val = ((val & 0x00FF00FF00FF00FFull) << 8) | ((val & 0xFF00FF00FF00FF00ull) >> 8);
+#endif
+				return val;
+			}
+
+			//True if every byte is in the range '0' to '9'
+			constexpr bool is_eight_digits(std::uint64_t val) {
+				return ((val & 0xF0F0F0F0F0F0F0F0ull) | (((val + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+			}
+
+			//Combine eight validated digits into their value. Pairs, then quads, then the whole word.
+			constexpr std::uint32_t parse_eight_digits(std::uint64_t val) {
+				constexpr std::uint64_t mask{ 0x000000FF000000FFull };
+				constexpr std::uint64_t mul1{ 100 + (1000000ull << 32) };
+				constexpr std::uint64_t mul2{ 1 + (10000ull << 32) };
+				val -= 0x3030303030303030ull;
+				val = (val * 10) + (val >> 8);
+				val = (((val & mask) * mul1) + (((val >> 16) & mask) * mul2)) >> 32;
+				return static_cast<std::uint32_t>(val);
+			}
+
+			//True if every byte is '0' or '1'
+			constexpr bool is_eight_binary_digits(std::uint64_t val) {
+				return (val & 0xFEFEFEFEFEFEFEFEull) == 0x3030303030303030ull;
+			}
+
+			//Gather the low bit of each byte into a single byte, with the first character as the most significant bit
+			constexpr std::uint8_t parse_eight_binary_digits(std::uint64_t val) {
+				return static_cast<std::uint8_t>(((val & 0x0101010101010101ull) * 0x8040201008040201ull) >> 56);
+			}
+		}
+
+		template<typename T>
+		static constexpr inline bool has_fast_decimal = std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= sizeof(std::uint64_t);
+
+		//Base 10 equivalent of std::from_chars for integral types of up to 64 bits
+		template<typename T>
+		std::from_chars_result parse_decimal(const char* first, const char* last, T& out) {
+			static_assert(has_fast_decimal<T>, "Fast decimal parsing is only supported on integral types of 64 bits or fewer");
+
+			const char* ptr{ first };
+			bool negative{ false };
+			if constexpr (std::is_signed_v<T>) {
+				if (ptr != last && *ptr == '-') {
+					negative = true;
+					++ptr;
+				}
+			}
+			const char* const digits_begin{ ptr };
+
+			//Leading zeroes don't contribute to the value, so don't let them count towards overflow
+			while (ptr != last && *ptr == '0') ++ptr;
+			const char* const significant{ ptr };
+
+			//Any 19 decimal digits will fit in a uint64, so we can take up to two full blocks of 8 without checking
+			std::uint64_t value{ 0 };
+			while (last - ptr >= 8 && ptr - significant <= 11) {
+				const auto block{ swar::load_eight(ptr) };
+				if (!swar::is_eight_digits(block)) break;
+				value = value * 100000000 + swar::parse_eight_digits(block);
+				ptr += 8;
+			}
+
+			bool overflow{ false };
+			for (; ptr != last && static_cast<unsigned char>(*ptr - '0') < 10; ++ptr) {
+				const unsigned digit = static_cast<unsigned char>(*ptr - '0');
+				const auto position{ ptr - significant };
+				if (position < 19) {
+					value = value * 10 + digit;
+				}
+				else if (position == 19 && !overflow && value <= ((std::numeric_limits<std::uint64_t>::max)() - digit) / 10) {
+					value = value * 10 + digit;
+				}
+				else {
+					overflow = true;
+				}
+			}
+
+			if (ptr == digits_begin) return { first, std::errc::invalid_argument };
+
+			using unsigned_t = std::make_unsigned_t<T>;
+			std::uint64_t limit{ (std::numeric_limits<unsigned_t>::max)() };
+			if constexpr (std::is_signed_v<T>) {
+				limit = static_cast<std::uint64_t>((std::numeric_limits<T>::max)()) + (negative ? 1 : 0);
+			}
+			if (overflow || value > limit) return { ptr, std::errc::result_out_of_range };
+
+			if (negative) {
+				//Done in two steps so the most negative value never overflows
+				out = static_cast<T>(-static_cast<long long>(value - 1) - 1);
+			}
+			else {
+				out = static_cast<T>(value);
+			}
+			return { ptr, std::errc{} };
+		}
+
+
+		//The equivalent of std::from_chars_result for any character type
+		template<typename CharT>
+		struct parse_result {
+			const CharT* ptr;
+			std::errc ec;
+		};
+
+		//Only ASCII digits and letters count, whatever the character type or locale.
+		//Returns a value of at least 36 for anything which is not a digit in any base.
+		template<typename CharT>
+		constexpr unsigned digit_value(CharT ch) {
+			const auto code{ static_cast<std::uint32_t>(ch) };
+			if (code - '0' < 10) return code - '0';
+			if ((code | 0x20) - 'a' < 26) return (code | 0x20) - 'a' + 10;
+			return 36;
+		}
+
+		template<typename CharT>
+		constexpr bool is_decimal_digit(CharT ch) {
+			return static_cast<std::uint32_t>(ch) - '0' < 10;
+		}
+
+		//Equivalent of integral std::from_chars, for any character type
+		template<typename T, typename CharT>
+		constexpr parse_result<CharT> parse_integer_chars(const CharT* first, const CharT* last, T& out, int base = 10) {
+			static_assert(has_fast_decimal<T>, "Integer parsing is only supported on integral types of 64 bits or fewer");
+
+			const CharT* ptr{ first };
+			bool negative{ false };
+			if constexpr (std::is_signed_v<T>) {
+				if (ptr != last && *ptr == CharT('-')) {
+					negative = true;
+					++ptr;
+				}
+			}
+			const CharT* const digits_begin{ ptr };
+
+			using unsigned_t = std::make_unsigned_t<T>;
+			std::uint64_t limit{ (std::numeric_limits<unsigned_t>::max)() };
+			if constexpr (std::is_signed_v<T>) {
+				limit = static_cast<std::uint64_t>((std::numeric_limits<T>::max)()) + (negative ? 1 : 0);
+			}
+
+			std::uint64_t value{ 0 };
+			bool overflow{ false };
+			for (; ptr != last; ++ptr) {
+				const unsigned digit{ digit_value(*ptr) };
+				if (digit >= static_cast<unsigned>(base)) break;
+				if (overflow || value > (limit - digit) / base) {
+					overflow = true;
+				}
+				else {
+					value = value * base + digit;
+				}
+			}
+
+			if (ptr == digits_begin) return { first, std::errc::invalid_argument };
+			if (overflow) return { ptr, std::errc::result_out_of_range };
+
+			if (negative) {
+				out = static_cast<T>(-static_cast<long long>(value - 1) - 1);
+			}
+			else {
+				out = static_cast<T>(value);
+			}
+			return { ptr, std::errc{} };
+		}
+
+
+
+		/*
+		*  Boolean parsing, from true/false, yes/no or 1/0. Every word is five characters or fewer, so the input is packed into a single word
+		*  and compared against the only candidate of that length. Ignoring case is then just setting bit 5 of each byte, which for these
+		*  words only ever merges a letter with its other case. Unlike the number parsers, the whole input must match.
+		*/
+		constexpr unsigned byte_shift(std::size_t index) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			return static_cast<unsigned>(56 - 8 * index);
+#else
+			return static_cast<unsigned>(8 * index);
+#endif
+		}
+
+		//The word as it would be loaded from memory
+		constexpr std::uint64_t pack_word(const char* in, std::size_t length) {
+			std::uint64_t out{ 0 };
+			for (std::size_t i = 0; i < length; ++i) out |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[i])) << byte_shift(i);
+			return out;
+		}
+
+		constexpr std::uint64_t case_mask(std::size_t length) {
+			std::uint64_t out{ 0 };
+			for (std::size_t i = 0; i < length; ++i) out |= std::uint64_t{ 0x20 } << byte_shift(i);
+			return out;
+		}
+
+		struct bool_word {
+			std::uint64_t word;
+			std::uint64_t mask;
+			bool value;
+		};
+
+		//Indexed by length. The one-character words are digits, which must not have their case folded.
+		constexpr inline bool_word bool_words[]{ { 0, 0, false }, { 0, 0, false }, { pack_word("no", 2), case_mask(2), false },
+			{ pack_word("yes", 3), case_mask(3), true }, { pack_word("true", 4), case_mask(4), true }, { pack_word("false", 5), case_mask(5), false } };
+
+		template<typename CharT>
+		parse_result<CharT> parse_bool_chars(const CharT* first, const CharT* last, bool& out) {
+			const auto length{ static_cast<std::size_t>(last - first) };
+			if (length == 0 || length >= std::size(bool_words)) return { first, std::errc::invalid_argument };
+
+			std::uint64_t word{ 0 };
+			if constexpr (std::is_same_v<CharT, char>) {
+				std::memcpy(&word, first, length);
+			}
+			else {
+				for (std::size_t i = 0; i < length; ++i) {
+					const auto code{ static_cast<std::uint32_t>(first[i]) };
+					if (code >= 0x80) return { first, std::errc::invalid_argument };
+					word |= static_cast<std::uint64_t>(code) << byte_shift(i);
+				}
+			}
+
+			if (length == 1) {
+				if (word != pack_word("1", 1) && word != pack_word("0", 1)) return { first, std::errc::invalid_argument };
+				out = (word == pack_word("1", 1));
+				return { last, std::errc{} };
+			}
+			const auto& candidate{ bool_words[length] };
+			if ((word | candidate.mask) != candidate.word) return { first, std::errc::invalid_argument };
+			out = candidate.value;
+			return { last, std::errc{} };
+		}
+
+
+
+		/*
+		*  Parsing in bases 2, 8 and 16. As each digit is a whole number of bits we can shift rather than multiply, and know exactly
+		*  how many significant digits fit in 64 bits, so the overflow check is only needed on the last digit or two.
+		*  Characters are decoded through a table; runs of binary digits are handled eight at a time.
+		*  Unlike the other kernels the sign is passed in, as it comes before any radix prefix which the caller has already stripped.
+		*/
+		constexpr std::array<unsigned char, 256> make_digit_table() {
+			std::array<unsigned char, 256> table{};
+			for (unsigned i = 0; i < table.size(); ++i) {
+				table[i] = static_cast<unsigned char>(digit_value(static_cast<char>(i)));
+			}
+			return table;
+		}
+		constexpr inline std::array<unsigned char, 256> digit_table{ make_digit_table() };
+
+		template<typename CharT>
+		constexpr unsigned lookup_digit(CharT ch) {
+			const auto code{ static_cast<std::uint32_t>(static_cast<std::make_unsigned_t<CharT>>(ch)) };
+			return code < digit_table.size() ? digit_table[code] : 36;
+		}
+
+		template<typename T, typename CharT>
+		parse_result<CharT> parse_power_of_two_radix(const CharT* first, const CharT* last, unsigned bits_per_digit, bool negative, T& out) {
+			static_assert(has_fast_decimal<T>, "Integer parsing is only supported on integral types of 64 bits or fewer");
+			const unsigned base{ 1u << bits_per_digit };
+			const std::size_t safe_digits{ 64 / bits_per_digit };
+
+			const CharT* ptr{ first };
+			while (ptr != last && *ptr == CharT('0')) ++ptr;
+			const CharT* const significant{ ptr };
+
+			std::uint64_t value{ 0 };
+			if constexpr (std::is_same_v<CharT, char>) {
+				if (bits_per_digit == 1) {
+					while (last - ptr >= 8 && static_cast<std::size_t>(ptr - significant) + 8 <= safe_digits) {
+						const auto block{ swar::load_eight(ptr) };
+						if (!swar::is_eight_binary_digits(block)) break;
+						value = (value << 8) | swar::parse_eight_binary_digits(block);
+						ptr += 8;
+					}
+				}
+			}
+
+			bool overflow{ false };
+			for (; ptr != last; ++ptr) {
+				const unsigned digit{ lookup_digit(*ptr) };
+				if (digit >= base) break;
+				if (static_cast<std::size_t>(ptr - significant) >= safe_digits && (value >> (64 - bits_per_digit)) != 0) {
+					overflow = true;
+				}
+				else {
+					value = (value << bits_per_digit) | digit;
+				}
+			}
+
+			if (ptr == first) return { first, std::errc::invalid_argument };
+
+			using unsigned_t = std::make_unsigned_t<T>;
+			std::uint64_t limit{ (std::numeric_limits<unsigned_t>::max)() };
+			if constexpr (std::is_signed_v<T>) {
+				limit = static_cast<std::uint64_t>((std::numeric_limits<T>::max)()) + (negative ? 1 : 0);
+			}
+			if (overflow || value > limit) return { ptr, std::errc::result_out_of_range };
+
+			if (negative) {
+				out = static_cast<T>(-static_cast<long long>(value - 1) - 1);
+			}
+			else {
+				out = static_cast<T>(value);
+			}
+			return { ptr, std::errc{} };
+		}
+
+
+
+		/*
+		*  Floating point parsing. Scanning the text is simple enough, the hard part is turning a decimal significand and exponent into
+		*  the correctly rounded binary value. For that we use the Eisel-Lemire algorithm (as used by fast_float and most modern
+		*  standard libraries), with Clinger's exact fast path in front of it for the very common short inputs.
+		*  In the rare case that the result can't be determined from the first 19 significant digits, we fall back to strtod on a
+		*  canonicalised copy of the input - which contains no decimal point and so is immune to the current locale.
+		*/
+		template<typename T>
+		struct float_traits;
+
+		template<>
+		struct float_traits<double> {
+			using bits_type = std::uint64_t;
+			static constexpr int mantissa_explicit_bits{ 52 };
+			static constexpr int minimum_exponent{ -1023 };
+			static constexpr int infinite_power{ 0x7FF };
+			static constexpr int smallest_power_of_ten{ -342 };
+			static constexpr int largest_power_of_ten{ 308 };
+			static constexpr int min_exponent_round_to_even{ -4 };
+			static constexpr int max_exponent_round_to_even{ 23 };
+			static constexpr int max_exponent_fast_path{ 22 };
+			static constexpr std::uint64_t max_mantissa_fast_path{ std::uint64_t{ 2 } << 52 };
+		};
+
+		template<>
+		struct float_traits<float> {
+			using bits_type = std::uint32_t;
+			static constexpr int mantissa_explicit_bits{ 23 };
+			static constexpr int minimum_exponent{ -127 };
+			static constexpr int infinite_power{ 0xFF };
+			static constexpr int smallest_power_of_ten{ -64 };
+			static constexpr int largest_power_of_ten{ 38 };
+			static constexpr int min_exponent_round_to_even{ -17 };
+			static constexpr int max_exponent_round_to_even{ 10 };
+			static constexpr int max_exponent_fast_path{ 10 };
+			static constexpr std::uint64_t max_mantissa_fast_path{ std::uint64_t{ 2 } << 23 };
+		};
+
+		//Exactly representable powers of ten, for the fast path
+		template<typename T>
+		constexpr T exact_power_of_ten(int exp) {
+			constexpr T powers[]{ T(1e0), T(1e1), T(1e2), T(1e3), T(1e4), T(1e5), T(1e6), T(1e7), T(1e8), T(1e9), T(1e10), T(1e11),
+				T(1e12), T(1e13), T(1e14), T(1e15), T(1e16), T(1e17), T(1e18), T(1e19), T(1e20), T(1e21), T(1e22) };
+			return powers[exp];
+		}
+
+		struct uint128 {
+			std::uint64_t low;
+			std::uint64_t high;
+		};
+
+		constexpr uint128 full_multiplication(std::uint64_t lhs, std::uint64_t rhs) {
+#ifdef __SIZEOF_INT128__
+			__extension__ using wide_type = unsigned __int128;
+			const wide_type product{ static_cast<wide_type>(lhs) * rhs };
+			return { static_cast<std::uint64_t>(product), static_cast<std::uint64_t>(product >> 64) };
+#else
+			const std::uint64_t lhs_lo{ lhs & 0xFFFFFFFF }, lhs_hi{ lhs >> 32 };
+			const std::uint64_t rhs_lo{ rhs & 0xFFFFFFFF }, rhs_hi{ rhs >> 32 };
+			const std::uint64_t lo_lo{ lhs_lo * rhs_lo };
+			const std::uint64_t hi_lo{ lhs_hi * rhs_lo };
+			const std::uint64_t lo_hi{ lhs_lo * rhs_hi };
+			const std::uint64_t hi_hi{ lhs_hi * rhs_hi };
+			const std::uint64_t cross{ (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi };
+			return { (cross << 32) | (lo_lo & 0xFFFFFFFF), (hi_lo >> 32) + (cross >> 32) + hi_hi };
+#endif
+		}
+
+		constexpr int leading_zeroes(std::uint64_t in) {
+#if defined(__cpp_lib_bitops)
+			return std::countl_zero(in);
+#elif defined(__GNUC__) || defined(__clang__)
+			return __builtin_clzll(in);
+#else
+			int count{ 0 };
+			if ((in & 0xFFFFFFFF00000000ull) == 0) { count += 32; in <<= 32; }
+			if ((in & 0xFFFF000000000000ull) == 0) { count += 16; in <<= 16; }
+			if ((in & 0xFF00000000000000ull) == 0) { count += 8; in <<= 8; }
+			if ((in & 0xF000000000000000ull) == 0) { count += 4; in <<= 4; }
+			if ((in & 0xC000000000000000ull) == 0) { count += 2; in <<= 2; }
+			if ((in & 0x8000000000000000ull) == 0) { count += 1; }
+			return count;
+#endif
+		}
+
+		//A binary floating point value before it is packed into its final representation
+		struct adjusted_mantissa {
+			std::uint64_t mantissa{ 0 };
+			int power2{ 0 };
+
+			constexpr bool operator==(const adjusted_mantissa& other) const {
+				return mantissa == other.mantissa && power2 == other.power2;
+			}
+			constexpr bool operator!=(const adjusted_mantissa& other) const {
+				return !(*this == other);
+			}
+		};
+
+		//The Eisel-Lemire algorithm. Computes the nearest binary value to w * 10^q, given that w is nonzero and exact.
+		template<typename T>
+		constexpr adjusted_mantissa eisel_lemire(std::int64_t q, std::uint64_t w) {
+			using traits = float_traits<T>;
+			adjusted_mantissa answer{};
+			if (w == 0 || q < traits::smallest_power_of_ten) return answer;
+			if (q > traits::largest_power_of_ten) {
+				answer.power2 = traits::infinite_power;
+				return answer;
+			}
+
+			const int lz{ leading_zeroes(w) };
+			w <<= lz;
+
+			//Multiply by the truncated power of five. We only need the second half of the table entry if the first is ambiguous
+			constexpr int bit_precision{ traits::mantissa_explicit_bits + 3 };
+			constexpr std::uint64_t precision_mask{ 0xFFFFFFFFFFFFFFFFull >> bit_precision };
+			const auto index{ 2 * static_cast<std::size_t>(q - tables::smallest_power_of_five) };
+			uint128 product{ full_multiplication(w, tables::power_of_five_128[index]) };
+			if ((product.high & precision_mask) == precision_mask) {
+				const uint128 second{ full_multiplication(w, tables::power_of_five_128[index + 1]) };
+				product.low += second.high;
+				if (second.high > product.low) ++product.high;
+			}
+
+			const int upper_bit{ static_cast<int>(product.high >> 63) };
+			const int shift{ upper_bit + 64 - traits::mantissa_explicit_bits - 3 };
+			answer.mantissa = product.high >> shift;
+			//Equivalent to floor(log2(10^q)) + 63, without the floating point
+			const int power{ static_cast<int>((((152170 + 65536) * q) >> 16) + 63) };
+			answer.power2 = power + upper_bit - lz - traits::minimum_exponent;
+
+			//Subnormal results
+			if (answer.power2 <= 0) {
+				if (-answer.power2 + 1 >= 64) {
+					return adjusted_mantissa{};
+				}
+				answer.mantissa >>= -answer.power2 + 1;
+				answer.mantissa += (answer.mantissa & 1);
+				answer.mantissa >>= 1;
+				answer.power2 = (answer.mantissa < (std::uint64_t{ 1 } << traits::mantissa_explicit_bits)) ? 0 : 1;
+				return answer;
+			}
+
+			//Exactly halfway between two values, so round to even rather than up
+			if (product.low <= 1 && q >= traits::min_exponent_round_to_even && q <= traits::max_exponent_round_to_even && (answer.mantissa & 3) == 1) {
+				if ((answer.mantissa << shift) == product.high) {
+					answer.mantissa &= ~std::uint64_t{ 1 };
+				}
+			}
+
+			answer.mantissa += (answer.mantissa & 1);
+			answer.mantissa >>= 1;
+			if (answer.mantissa >= (std::uint64_t{ 2 } << traits::mantissa_explicit_bits)) {
+				answer.mantissa = std::uint64_t{ 1 } << traits::mantissa_explicit_bits;
+				++answer.power2;
+			}
+			answer.mantissa &= ~(std::uint64_t{ 1 } << traits::mantissa_explicit_bits);
+			if (answer.power2 >= traits::infinite_power) {
+				answer.power2 = traits::infinite_power;
+				answer.mantissa = 0;
+			}
+			return answer;
+		}
+
+		//Builds the value with arithmetic rather than by punning the bits, so it can be used in a constant expression.
+		//Every step is a multiplication by a power of two which is exact, so this gives the same result as to_floating
+		template<typename T>
+		constexpr T make_floating(adjusted_mantissa am, bool negative) {
+			using traits = float_traits<T>;
+			const std::uint64_t hidden_bit{ am.power2 == 0 ? 0 : std::uint64_t{ 1 } << traits::mantissa_explicit_bits };
+			T value{ static_cast<T>(am.mantissa | hidden_bit) };
+			const int exponent{ (am.power2 == 0 ? 1 : am.power2) + traits::minimum_exponent - traits::mantissa_explicit_bits };
+
+			T base{ exponent < 0 ? T(0.5) : T(2) };
+			for (unsigned remaining = static_cast<unsigned>(exponent < 0 ? -exponent : exponent); remaining != 0; ) {
+				if (remaining & 1) value *= base;
+				remaining >>= 1;
+				if (remaining != 0) base *= base;
+			}
+			return negative ? -value : value;
+		}
+
+		template<typename T>
+		T to_floating(adjusted_mantissa am, bool negative) {
+			using traits = float_traits<T>;
+			using bits_type = typename traits::bits_type;
+			bits_type word{ static_cast<bits_type>(am.mantissa) };
+			word |= static_cast<bits_type>(am.power2) << traits::mantissa_explicit_bits;
+			if (negative) word |= bits_type{ 1 } << (sizeof(bits_type) * 8 - 1);
+			T out;
+			std::memcpy(&out, &word, sizeof(out));
+			return out;
+		}
+
+		//The decimal form of a number as read from the text; value = mantissa * 10^exponent
+		template<typename CharT>
+		struct decimal_number {
+			std::uint64_t mantissa{ 0 };
+			std::int64_t exponent{ 0 };
+			bool negative{ false };
+			//More than 19 significant digits, not all of which made it into the mantissa
+			bool truncated{ false };
+			//The digits and decimal point, for the slow path
+			const CharT* digits_begin{ nullptr };
+			const CharT* digits_end{ nullptr };
+			std::int64_t explicit_exponent{ 0 };
+		};
+
+		template<typename CharT>
+		constexpr bool match_insensitive(const CharT* first, const CharT* last, const char* word) {
+			for (; *word != '\0'; ++first, ++word) {
+				if (first == last || (static_cast<std::uint32_t>(*first) | 0x20) != static_cast<std::uint32_t>(*word)) return false;
+			}
+			return true;
+		}
+
+		//inf, infinity, nan, and nan(chars), all case insensitive
+		template<typename T, typename CharT>
+		constexpr parse_result<CharT> parse_special(const CharT* first, const CharT* ptr, const CharT* last, bool negative, T& out) {
+			if (match_insensitive(ptr, last, "inf")) {
+				ptr += match_insensitive(ptr, last, "infinity") ? 8 : 3;
+				out = negative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+				return { ptr, std::errc{} };
+			}
+			if (match_insensitive(ptr, last, "nan")) {
+				ptr += 3;
+				if (ptr != last && *ptr == CharT('(')) {
+					const CharT* close{ ptr + 1 };
+					while (close != last && (digit_value(*close) < 36 || *close == CharT('_'))) ++close;
+					if (close != last && *close == CharT(')')) ptr = close + 1;
+				}
+				out = negative ? -std::numeric_limits<T>::quiet_NaN() : std::numeric_limits<T>::quiet_NaN();
+				return { ptr, std::errc{} };
+			}
+			return { first, std::errc::invalid_argument };
+		}
+
+		template<typename CharT>
+		constexpr parse_result<CharT> scan_decimal(const CharT* first, const CharT* last, decimal_number<CharT>& number) {
+			const CharT* ptr{ first };
+			number.negative = (ptr != last && *ptr == CharT('-'));
+			if (number.negative) ++ptr;
+			number.digits_begin = ptr;
+
+			int significant{ 0 };
+			bool seen_digit{ false };
+			bool in_fraction{ false };
+			for (; ptr != last; ++ptr) {
+				if (*ptr == CharT('.') && !in_fraction) {
+					in_fraction = true;
+					continue;
+				}
+				if (!is_decimal_digit(*ptr)) break;
+				seen_digit = true;
+
+				const unsigned digit{ static_cast<unsigned>(*ptr - CharT('0')) };
+				if (significant == 0 && digit == 0) {
+					//Leading zeroes
+					if (in_fraction) --number.exponent;
+				}
+				else if (significant < 19) {
+					number.mantissa = number.mantissa * 10 + digit;
+					++significant;
+					if (in_fraction) --number.exponent;
+				}
+				else {
+					number.truncated |= (digit != 0);
+					if (!in_fraction) ++number.exponent;
+				}
+			}
+			if (!seen_digit) return { first, std::errc::invalid_argument };
+			number.digits_end = ptr;
+
+			//An exponent is only consumed if it is well formed; "1e" is just the 1
+			if (ptr != last && (*ptr == CharT('e') || *ptr == CharT('E'))) {
+				const CharT* exp_ptr{ ptr + 1 };
+				bool exp_negative{ false };
+				if (exp_ptr != last && (*exp_ptr == CharT('-') || *exp_ptr == CharT('+'))) {
+					exp_negative = (*exp_ptr == CharT('-'));
+					++exp_ptr;
+				}
+				if (exp_ptr != last && is_decimal_digit(*exp_ptr)) {
+					std::int64_t exp_value{ 0 };
+					for (; exp_ptr != last && is_decimal_digit(*exp_ptr); ++exp_ptr) {
+						//Saturate well beyond the range where every value is 0 or infinity
+						if (exp_value < 0x10000000) exp_value = exp_value * 10 + (*exp_ptr - CharT('0'));
+					}
+					number.explicit_exponent = exp_negative ? -exp_value : exp_value;
+					number.exponent += number.explicit_exponent;
+					ptr = exp_ptr;
+				}
+			}
+			return { ptr, std::errc{} };
+		}
+
+		//The slow path. Rewrite the number as plain digits and an exponent with no decimal point, and hand it to the C library.
+		template<typename T, typename CharT>
+		T parse_canonical(const decimal_number<CharT>& number) {
+			//Every halfway point between two values of T is a binary fraction with at most one more fractional bit than the smallest subnormal,
+			//and so has no more significant decimal digits than that; nor do the ones above 1, which have few fractional bits.
+			//So this many digits decide the rounding of any value, and past that we only need to know whether anything was nonzero.
+			//For double that is 1075 digits, but an x87 or quad long double needs over 16k, which we don't put on the stack.
+			constexpr int max_digits{ std::numeric_limits<T>::digits - std::numeric_limits<T>::min_exponent + 1 };
+			constexpr std::size_t buffer_size{ max_digits + 32 };
+			constexpr std::size_t max_stack_buffer{ 2048 };
+			std::array<char, (buffer_size <= max_stack_buffer ? buffer_size : 1)> stack_buffer;
+			const std::unique_ptr<char[]> heap_buffer{ buffer_size <= max_stack_buffer ? nullptr : new char[buffer_size] };
+			char* const buffer{ buffer_size <= max_stack_buffer ? stack_buffer.data() : heap_buffer.get() };
+			char* out{ buffer };
+			if (number.negative) *out++ = '-';
+
+			int kept{ 0 };
+			std::int64_t exponent{ number.explicit_exponent };
+			bool in_fraction{ false };
+			bool sticky{ false };
+			for (const CharT* ptr = number.digits_begin; ptr != number.digits_end; ++ptr) {
+				if (*ptr == CharT('.')) {
+					in_fraction = true;
+					continue;
+				}
+				const char digit{ static_cast<char>(*ptr - CharT('0') + '0') };
+				if (in_fraction) --exponent;
+				if (kept == 0 && digit == '0') continue;
+				if (kept < max_digits) {
+					*out++ = digit;
+					++kept;
+				}
+				else {
+					sticky |= (digit != '0');
+					++exponent;
+				}
+			}
+			if (sticky) {
+				*out++ = '1';
+				--exponent;
+			}
+			if (kept == 0) *out++ = '0';
+
+			constexpr std::int64_t exponent_limit{ 99999 };
+			exponent = exponent < -exponent_limit ? -exponent_limit : (exponent > exponent_limit ? exponent_limit : exponent);
+			*out++ = 'e';
+			std::to_chars(out, buffer + buffer_size - 1, exponent).ptr[0] = '\0';
+
+			if constexpr (std::is_same_v<T, float>) {
+				return std::strtof(buffer, nullptr);
+			}
+			else if constexpr (std::is_same_v<T, double>) {
+				return std::strtod(buffer, nullptr);
+			}
+			else {
+				return std::strtold(buffer, nullptr);
+			}
+		}
+
+		//The floating point parser proper. In a constant expression we can't pun bits or call the C library,
+		//so that form builds its result arithmetically and reports inputs which need the slow path as not_supported.
+		template<bool ConstantEvaluation, typename T, typename CharT>
+		constexpr parse_result<CharT> parse_floating_impl(const CharT* first, const CharT* last, T& out) {
+			const CharT* ptr{ first };
+			const bool negative{ ptr != last && *ptr == CharT('-') };
+			if (negative) ++ptr;
+			if (ptr != last && ((static_cast<std::uint32_t>(*ptr) | 0x20) == 'i' || (static_cast<std::uint32_t>(*ptr) | 0x20) == 'n')) {
+				return parse_special(first, ptr, last, negative, out);
+			}
+
+			decimal_number<CharT> number{};
+			const auto scanned{ scan_decimal(first, last, number) };
+			if (scanned.ec != std::errc{}) return scanned;
+
+			if (number.mantissa == 0) {
+				out = negative ? -T(0) : T(0);
+				return scanned;
+			}
+
+			//Types which we can't represent with float_traits (i.e. an extended long double) always take the slow path
+			using format_type = std::conditional_t<std::is_same_v<T, float>, float, std::conditional_t<std::numeric_limits<T>::digits == 53, double, void>>;
+			if constexpr (std::is_void_v<format_type>) {
+				if constexpr (ConstantEvaluation) {
+					return { first, std::errc::not_supported };
+				}
+				else {
+					const T value{ parse_canonical<T>(number) };
+					if (value == 0 || value == std::numeric_limits<T>::infinity() || value == -std::numeric_limits<T>::infinity()) return { scanned.ptr, std::errc::result_out_of_range };
+					out = value;
+					return scanned;
+				}
+			}
+			else {
+				using traits = float_traits<format_type>;
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0
+				//Clinger's fast path. Both the mantissa and the power of ten are exact, so one IEEE operation rounds correctly.
+				if (!number.truncated && number.mantissa <= traits::max_mantissa_fast_path
+					&& number.exponent >= -traits::max_exponent_fast_path && number.exponent <= traits::max_exponent_fast_path) {
+					format_type value{ static_cast<format_type>(number.mantissa) };
+					if (number.exponent < 0) {
+						value = value / exact_power_of_ten<format_type>(static_cast<int>(-number.exponent));
+					}
+					else {
+						value = value * exact_power_of_ten<format_type>(static_cast<int>(number.exponent));
+					}
+					out = static_cast<T>(negative ? -value : value);
+					return scanned;
+				}
+#endif
+				adjusted_mantissa am{ eisel_lemire<format_type>(number.exponent, number.mantissa) };
+				//If digits were dropped, the true value lies between mantissa and mantissa + 1; if both round the same way then we have our answer
+				if (number.truncated && am != eisel_lemire<format_type>(number.exponent, number.mantissa + 1)) {
+					if constexpr (ConstantEvaluation) {
+						return { first, std::errc::not_supported };
+					}
+					else {
+						const format_type value{ parse_canonical<format_type>(number) };
+						if (value == 0 || value == std::numeric_limits<format_type>::infinity() || value == -std::numeric_limits<format_type>::infinity()) return { scanned.ptr, std::errc::result_out_of_range };
+						out = static_cast<T>(value);
+						return scanned;
+					}
+				}
+
+				if (am.power2 == traits::infinite_power || (am.power2 == 0 && am.mantissa == 0)) return { scanned.ptr, std::errc::result_out_of_range };
+				if constexpr (ConstantEvaluation) {
+					out = static_cast<T>(make_floating<format_type>(am, negative));
+				}
+				else {
+					out = static_cast<T>(to_floating<format_type>(am, negative));
+				}
+				return scanned;
+			}
+		}
+
+		//Equivalent of floating point std::from_chars in general format, for any character type
+		template<typename T, typename CharT>
+		parse_result<CharT> parse_floating_chars(const CharT* first, const CharT* last, T& out) {
+			return parse_floating_impl<false>(first, last, out);
+		}
+
+		//As above, but usable in constant expressions
+		template<typename T, typename CharT>
+		constexpr parse_result<CharT> parse_floating_constexpr(const CharT* first, const CharT* last, T& out) {
+			return parse_floating_impl<true>(first, last, out);
+		}
+
+
+
+		/*
+		*  Decimal integer formatting. The length is worked out before anything is written, from the bit width of the value and a single
+		*  comparison against a power of ten, so a string can be allocated once at exactly the right size and the digits written straight into it.
+		*  Digits are then produced two at a time from a table of pairs, from the least significant end backwards.
+		*/
+		constexpr inline char digit_pairs[] =
+			"00010203040506070809"
+			"10111213141516171819"
+			"20212223242526272829"
+			"30313233343536373839"
+			"40414243444546474849"
+			"50515253545556575859"
+			"60616263646566676869"
+			"70717273747576777879"
+			"80818283848586878889"
+			"90919293949596979899";
+
+		//10^n for n >= 1. The first entry is 0 rather than 1 so that 0 comes out as one digit
+		constexpr inline std::uint64_t digit_count_thresholds[]{ 0, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+			10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull, 1000000000000000ull,
+			10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull };
+
+		constexpr int count_decimal_digits(std::uint64_t value) {
+			//(bits * 1233) >> 12 is floor(bits * log10(2)) for every width up to 64, which is either the digit count or one short of it
+			const int bits{ 64 - leading_zeroes(value | 1) };
+			const int guess{ (bits * 1233) >> 12 };
+			return guess + (value >= digit_count_thresholds[guess] ? 1 : 0);
+		}
+
+		//Writes the digits of the value so that they end just before last
+		template<typename CharT>
+		constexpr void write_digits_backwards(CharT* last, std::uint64_t value) {
+			//Once the value fits in 32 bits we drop to 32-bit division, which matters on 32-bit targets
+			while (value > 0xFFFFFFFFu) {
+				const auto pair{ static_cast<std::size_t>(value % 100) * 2 };
+				value /= 100;
+				*--last = static_cast<CharT>(digit_pairs[pair + 1]);
+				*--last = static_cast<CharT>(digit_pairs[pair]);
+			}
+			auto small_value{ static_cast<std::uint32_t>(value) };
+			while (small_value >= 100) {
+				const auto pair{ static_cast<std::size_t>(small_value % 100) * 2 };
+				small_value /= 100;
+				*--last = static_cast<CharT>(digit_pairs[pair + 1]);
+				*--last = static_cast<CharT>(digit_pairs[pair]);
+			}
+			if (small_value >= 10) {
+				*--last = static_cast<CharT>(digit_pairs[small_value * 2 + 1]);
+				*--last = static_cast<CharT>(digit_pairs[small_value * 2]);
+			}
+			else {
+				*--last = static_cast<CharT>('0' + small_value);
+			}
+		}
+
+		//Negating in unsigned arithmetic so the most negative value doesn't overflow
+		template<typename IntT>
+		constexpr std::uint64_t decimal_magnitude(IntT value) {
+			if constexpr (std::is_signed_v<IntT>) {
+				if (value < 0) return 0 - static_cast<std::uint64_t>(value);
+			}
+			return static_cast<std::uint64_t>(value);
+		}
+
+		//The exact number of characters write_decimal produces for the value, including any sign
+		template<typename IntT>
+		constexpr std::size_t decimal_length(IntT value) {
+			static_assert(has_fast_decimal<IntT>, "Fast decimal formatting is only supported on integral types of 64 bits or fewer");
+			std::size_t length{ static_cast<std::size_t>(count_decimal_digits(decimal_magnitude(value))) };
+			if constexpr (std::is_signed_v<IntT>) {
+				if (value < 0) ++length;
+			}
+			return length;
+		}
+
+		//Writes the value into [first, first + length), where length must be decimal_length(value)
+		template<typename IntT, typename CharT>
+		constexpr void write_decimal(CharT* first, std::size_t length, IntT value) {
+			write_digits_backwards(first + length, decimal_magnitude(value));
+			if constexpr (std::is_signed_v<IntT>) {
+				if (value < 0) *first = CharT('-');
+			}
+		}
+
+		//Base 10 equivalent of std::to_chars for integral types of up to 64 bits
+		template<typename IntT>
+		constexpr std::to_chars_result format_decimal(char* first, char* last, IntT value) {
+			const auto length{ decimal_length(value) };
+			if (static_cast<std::size_t>(last - first) < length) return { last, std::errc::value_too_large };
+			write_decimal(first, length, value);
+			return { first + length, std::errc{} };
+		}
+
+	}
+}
+
+#endif
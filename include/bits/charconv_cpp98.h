@@ -0,0 +1,735 @@
+#ifndef DP_CPP98_CHARCONV
+#define DP_CPP98_CHARCONV
+
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#include <climits>
+#include <string>
+#include <sstream>
+
+/*
+*  Number parsing and formatting tools shared by the C++98 and Borland convert_to headers.
+*  These exist so that both headers read numbers with the same rules as the C++17 header, rather than whatever strtol(..., 0) does,
+*  and so that writing a number out doesn't cost a stringstream (and its locale, allocation and virtual calls) every time.
+*
+*  Full documentation here: https://github.com/DryPerspective/C_Builder_Extras/wiki/Convert
+*/
+
+namespace dp {
+
+	/*
+	*  The base in which to read an integer. With detect, a prefix of 0x, 0b or 0o (in either case) selects hex, binary or octal,
+	*  as do the # and Delphi-style $ prefixes for hex. Anything else, including a leading 0, is decimal.
+	*  The explicit bases also accept their own prefix. In every case a '-' comes before the prefix.
+	*  No enum class in C++98, so the struct gives us the same dp::radix::hex spelling as the C++17 header.
+	*/
+	struct radix {
+		enum type {
+			detect,
+			dec,
+			hex,
+			bin,
+			oct
+		};
+	};
+
+	namespace conv_impl {
+
+		//No long long in C++98, but every compiler we care about has a 64-bit integer under some name
+#ifdef __BORLANDC__
+		typedef unsigned __int64 uint64;
+#else
+		typedef unsigned long long uint64;
+#endif
+		typedef unsigned int uint32;
+
+		//Only ASCII digits and letters count. Returns at least 36 for anything which is not a digit in any base.
+		inline unsigned int radix_digit_code(unsigned int code) {
+			if (code - '0' < 10) return code - '0';
+			if ((code | 0x20) - 'a' < 26) return (code | 0x20) - 'a' + 10;
+			return 36;
+		}
+
+		inline unsigned int radix_digit(char ch) {
+			return radix_digit_code(static_cast<unsigned char>(ch));
+		}
+
+		//Wide characters are read as they are, so that a Delphi UnicodeString needs no narrowing first
+		inline unsigned int radix_digit(wchar_t ch) {
+			return radix_digit_code(static_cast<unsigned int>(ch));
+		}
+
+		//Skips past any prefix which is valid for the requested radix, and returns the base of the digits which follow
+		template<typename CharT>
+		unsigned int strip_radix_prefix(const CharT*& first, const CharT* last, radix::type base) {
+			unsigned int prefix_base = 10;
+			std::ptrdiff_t prefix_length = 0;
+			if (last - first >= 2 && (first[0] == '#' || first[0] == '$')) {
+				prefix_base = 16;
+				prefix_length = 1;
+			}
+			else if (last - first >= 3 && first[0] == '0') {
+				switch (first[1] | 0x20) {
+				case 'x': prefix_base = 16; prefix_length = 2; break;
+				case 'b': prefix_base = 2; prefix_length = 2; break;
+				case 'o': prefix_base = 8; prefix_length = 2; break;
+				default: break;
+				}
+			}
+
+			const unsigned int requested = base == radix::hex ? 16 : base == radix::bin ? 2 : base == radix::oct ? 8 : 10;
+			if (base != radix::detect && prefix_base != requested) return requested;
+			if (prefix_length != 0 && radix_digit(first[prefix_length]) < prefix_base) {
+				first += prefix_length;
+				return prefix_base;
+			}
+			return requested;
+		}
+
+		/*
+		*  Range-checked integer parsing for any integral type up to 64 bits, on a (pointer, length) pair so it never needs the text
+		*  to be null-terminated and never depends on the locale. As with the C++17 header, the longest valid prefix of the text is read.
+		*  Works on char or wchar_t.
+		*
+		*  For the sake of code written against the strtol these headers used to call, leading whitespace and a '+' are still accepted,
+		*  which the C++17 header does not do. The sign comes before any radix prefix; unsigned types take a '+' but not a '-'.
+		*  One deliberate difference from strtol(..., 0) remains: a leading 0 does not mean octal, so "010" is ten, as in the C++17 header.
+		*  Use radix::oct or the 0o prefix for octal.
+		*/
+		template<typename CharT>
+		bool is_strtol_space(CharT ch) {
+			return ch == CharT(' ') || (ch >= CharT('\t') && ch <= CharT('\r'));
+		}
+
+		template<typename CharT, typename T>
+		bool parse_integer(const CharT* first, const CharT* last, radix::type base, T& out) {
+			const bool is_signed = static_cast<T>(-1) < static_cast<T>(0);
+			while (first != last && is_strtol_space(*first)) ++first;
+			const bool negative = is_signed && first != last && *first == '-';
+			if (negative || (first != last && *first == '+')) ++first;
+			const unsigned int digit_base = strip_radix_prefix(first, last, base);
+
+			const CharT* ptr = first;
+			while (ptr != last && *ptr == '0') ++ptr;
+			const CharT* const significant = ptr;
+
+			//Up to this many significant digits can't overflow 64 bits, so only the last one or two need checking
+			const std::ptrdiff_t safe_digits = digit_base == 10 ? 19 : digit_base == 16 ? 16 : digit_base == 8 ? 21 : 64;
+			const uint64 max_uint64 = ~static_cast<uint64>(0);
+			uint64 value = 0;
+			for (; ptr != last; ++ptr) {
+				const unsigned int digit = radix_digit(*ptr);
+				if (digit >= digit_base) break;
+				if (ptr - significant >= safe_digits && value > (max_uint64 - digit) / digit_base) return false;
+				value = value * digit_base + digit;
+			}
+			if (ptr == first) return false;
+
+			const uint64 max_positive = is_signed ? (static_cast<uint64>(1) << (sizeof(T) * CHAR_BIT - 1)) - 1 : static_cast<uint64>(static_cast<T>(-1));
+			if (value > max_positive + (negative ? 1 : 0)) return false;
+
+			//Done in two steps so the most negative value never overflows
+			out = negative && value != 0 ? static_cast<T>(-static_cast<T>(value - 1) - 1) : static_cast<T>(value);
+			return true;
+		}
+
+
+//Spelled this way so we don't need a suffix for 64-bit literals, which C++98 doesn't have
+#define DP_UINT64(high, low) ((static_cast<dp::conv_impl::uint64>(high) << 32) | static_cast<dp::conv_impl::uint64>(low))
+
+		/*
+		*  Integer formatting. Digits are produced two at a time from a table of pairs, from the least significant end backwards,
+		*  which halves the number of divisions. Once the value fits in 32 bits we drop to 32-bit division, which matters on 32-bit targets.
+		*/
+		enum {
+			//Enough for the sign and digits of any integer up to 64 bits
+			max_integer_chars = 21
+		};
+
+		inline const char* digit_pairs() {
+			static const char pairs[] =
+				"00010203040506070809"
+				"10111213141516171819"
+				"20212223242526272829"
+				"30313233343536373839"
+				"40414243444546474849"
+				"50515253545556575859"
+				"60616263646566676869"
+				"70717273747576777879"
+				"80818283848586878889"
+				"90919293949596979899";
+			return pairs;
+		}
+
+		//Writes the digits of the value so that they end just before last. Returns the first character written.
+		inline char* format_digits_backwards(char* last, uint64 value) {
+			const char* const pairs = digit_pairs();
+			while (value > 0xFFFFFFFFu) {
+				const uint32 pair = static_cast<uint32>(value % 100) * 2;
+				value /= 100;
+				*--last = pairs[pair + 1];
+				*--last = pairs[pair];
+			}
+			uint32 small_value = static_cast<uint32>(value);
+			while (small_value >= 100) {
+				const uint32 pair = (small_value % 100) * 2;
+				small_value /= 100;
+				*--last = pairs[pair + 1];
+				*--last = pairs[pair];
+			}
+			if (small_value >= 10) {
+				*--last = pairs[small_value * 2 + 1];
+				*--last = pairs[small_value * 2];
+			}
+			else {
+				*--last = static_cast<char>('0' + small_value);
+			}
+			return last;
+		}
+
+		//Comparing an unsigned value with zero draws a warning, so only ask the question of signed types
+		template<bool is_signed>
+		struct sign_of {
+			template<typename T>
+			static bool negative(T value) { return value < 0; }
+		};
+		template<>
+		struct sign_of<false> {
+			template<typename T>
+			static bool negative(T) { return false; }
+		};
+
+		//Writes the value so that it ends just before last, which must have max_integer_chars of space before it.
+		//Returns the first character written.
+		template<typename T>
+		char* format_integer(char* last, T value) {
+			const bool negative = sign_of<(static_cast<T>(-1) < static_cast<T>(0))>::negative(value);
+			//Negating in unsigned arithmetic so the most negative value doesn't overflow
+			const uint64 magnitude = negative ? 0 - static_cast<uint64>(value) : static_cast<uint64>(value);
+			char* first = format_digits_backwards(last, magnitude);
+			if (negative) *--first = '-';
+			return first;
+		}
+
+
+		/*
+		*  Shortest floating point formatting, using Florian Loitsch's Grisu3 algorithm.
+		*  Grisu3 works in 64-bit integer arithmetic and knows when the error in that arithmetic leaves it unable to prove that its digits
+		*  are the shortest and closest which read back to the value. For the few values in a couple of hundred where it can't, we fall back
+		*  to an exact bignum digit generator (Steele & White, as refined by Burger & Dybvig), so the digits are always the ones std::to_chars chooses.
+		*  It only knows the layout of IEEE single and double precision, so long double keeps to stringstream.
+		*/
+		namespace grisu {
+
+			template<typename FloatT>
+			struct float_layout {};
+
+			template<>
+			struct float_layout<double> {
+				typedef uint64 bits_type;
+				enum {
+					significand_bits = 52,
+					exponent_mask = 0x7FF,
+					exponent_bias = 1075,
+					denormal_exponent = -1074
+				};
+			};
+
+			template<>
+			struct float_layout<float> {
+				typedef uint32 bits_type;
+				enum {
+					significand_bits = 23,
+					exponent_mask = 0xFF,
+					exponent_bias = 150,
+					denormal_exponent = -149
+				};
+			};
+
+			//A floating point number with a 64-bit significand and no implicit bit: f * 2^e
+			struct diy_fp {
+				uint64 f;
+				int e;
+
+				diy_fp() : f(0), e(0) {}
+				diy_fp(uint64 in_f, int in_e) : f(in_f), e(in_e) {}
+			};
+
+			//The top 64 bits of the 128-bit product, rounded
+			inline diy_fp multiply(const diy_fp& lhs, const diy_fp& rhs) {
+				const uint64 mask = 0xFFFFFFFFu;
+				const uint64 a = lhs.f >> 32;
+				const uint64 b = lhs.f & mask;
+				const uint64 c = rhs.f >> 32;
+				const uint64 d = rhs.f & mask;
+				const uint64 ac = a * c;
+				const uint64 bc = b * c;
+				const uint64 ad = a * d;
+				const uint64 bd = b * d;
+				uint64 middle = (bd >> 32) + (ad & mask) + (bc & mask);
+				middle += 1u << 31;
+				return diy_fp(ac + (ad >> 32) + (bc >> 32) + (middle >> 32), lhs.e + rhs.e + 64);
+			}
+
+			inline diy_fp normalize(diy_fp in) {
+				while ((in.f & DP_UINT64(0x80000000, 0)) == 0) {
+					in.f <<= 1;
+					--in.e;
+				}
+				return in;
+			}
+
+			//Normalized powers of ten from 10^-348 to 10^340 in steps of 8, rounded to nearest
+			inline diy_fp cached_power(int e, int& k) {
+				static const uint64 significands[] = {
+					DP_UINT64(0xfa8fd5a0, 0x081c0288), DP_UINT64(0xbaaee17f, 0xa23ebf76), DP_UINT64(0x8b16fb20, 0x3055ac76),
+					DP_UINT64(0xcf42894a, 0x5dce35ea), DP_UINT64(0x9a6bb0aa, 0x55653b2d), DP_UINT64(0xe61acf03, 0x3d1a45df),
+					DP_UINT64(0xab70fe17, 0xc79ac6ca), DP_UINT64(0xff77b1fc, 0xbebcdc4f), DP_UINT64(0xbe5691ef, 0x416bd60c),
+					DP_UINT64(0x8dd01fad, 0x907ffc3c), DP_UINT64(0xd3515c28, 0x31559a83), DP_UINT64(0x9d71ac8f, 0xada6c9b5),
+					DP_UINT64(0xea9c2277, 0x23ee8bcb), DP_UINT64(0xaecc4991, 0x4078536d), DP_UINT64(0x823c1279, 0x5db6ce57),
+					DP_UINT64(0xc2109436, 0x4dfb5637), DP_UINT64(0x9096ea6f, 0x3848984f), DP_UINT64(0xd77485cb, 0x25823ac7),
+					DP_UINT64(0xa086cfcd, 0x97bf97f4), DP_UINT64(0xef340a98, 0x172aace5), DP_UINT64(0xb23867fb, 0x2a35b28e),
+					DP_UINT64(0x84c8d4df, 0xd2c63f3b), DP_UINT64(0xc5dd4427, 0x1ad3cdba), DP_UINT64(0x936b9fce, 0xbb25c996),
+					DP_UINT64(0xdbac6c24, 0x7d62a584), DP_UINT64(0xa3ab6658, 0x0d5fdaf6), DP_UINT64(0xf3e2f893, 0xdec3f126),
+					DP_UINT64(0xb5b5ada8, 0xaaff80b8), DP_UINT64(0x87625f05, 0x6c7c4a8b), DP_UINT64(0xc9bcff60, 0x34c13053),
+					DP_UINT64(0x964e858c, 0x91ba2655), DP_UINT64(0xdff97724, 0x70297ebd), DP_UINT64(0xa6dfbd9f, 0xb8e5b88f),
+					DP_UINT64(0xf8a95fcf, 0x88747d94), DP_UINT64(0xb9447093, 0x8fa89bcf), DP_UINT64(0x8a08f0f8, 0xbf0f156b),
+					DP_UINT64(0xcdb02555, 0x653131b6), DP_UINT64(0x993fe2c6, 0xd07b7fac), DP_UINT64(0xe45c10c4, 0x2a2b3b06),
+					DP_UINT64(0xaa242499, 0x697392d3), DP_UINT64(0xfd87b5f2, 0x8300ca0e), DP_UINT64(0xbce50864, 0x92111aeb),
+					DP_UINT64(0x8cbccc09, 0x6f5088cc), DP_UINT64(0xd1b71758, 0xe219652c), DP_UINT64(0x9c400000, 0x00000000),
+					DP_UINT64(0xe8d4a510, 0x00000000), DP_UINT64(0xad78ebc5, 0xac620000), DP_UINT64(0x813f3978, 0xf8940984),
+					DP_UINT64(0xc097ce7b, 0xc90715b3), DP_UINT64(0x8f7e32ce, 0x7bea5c70), DP_UINT64(0xd5d238a4, 0xabe98068),
+					DP_UINT64(0x9f4f2726, 0x179a2245), DP_UINT64(0xed63a231, 0xd4c4fb27), DP_UINT64(0xb0de6538, 0x8cc8ada8),
+					DP_UINT64(0x83c7088e, 0x1aab65db), DP_UINT64(0xc45d1df9, 0x42711d9a), DP_UINT64(0x924d692c, 0xa61be758),
+					DP_UINT64(0xda01ee64, 0x1a708dea), DP_UINT64(0xa26da399, 0x9aef774a), DP_UINT64(0xf209787b, 0xb47d6b85),
+					DP_UINT64(0xb454e4a1, 0x79dd1877), DP_UINT64(0x865b8692, 0x5b9bc5c2), DP_UINT64(0xc83553c5, 0xc8965d3d),
+					DP_UINT64(0x952ab45c, 0xfa97a0b3), DP_UINT64(0xde469fbd, 0x99a05fe3), DP_UINT64(0xa59bc234, 0xdb398c25),
+					DP_UINT64(0xf6c69a72, 0xa3989f5c), DP_UINT64(0xb7dcbf53, 0x54e9bece), DP_UINT64(0x88fcf317, 0xf22241e2),
+					DP_UINT64(0xcc20ce9b, 0xd35c78a5), DP_UINT64(0x98165af3, 0x7b2153df), DP_UINT64(0xe2a0b5dc, 0x971f303a),
+					DP_UINT64(0xa8d9d153, 0x5ce3b396), DP_UINT64(0xfb9b7cd9, 0xa4a7443c), DP_UINT64(0xbb764c4c, 0xa7a44410),
+					DP_UINT64(0x8bab8eef, 0xb6409c1a), DP_UINT64(0xd01fef10, 0xa657842c), DP_UINT64(0x9b10a4e5, 0xe9913129),
+					DP_UINT64(0xe7109bfb, 0xa19c0c9d), DP_UINT64(0xac2820d9, 0x623bf429), DP_UINT64(0x80444b5e, 0x7aa7cf85),
+					DP_UINT64(0xbf21e440, 0x03acdd2d), DP_UINT64(0x8e679c2f, 0x5e44ff8f), DP_UINT64(0xd433179d, 0x9c8cb841),
+					DP_UINT64(0x9e19db92, 0xb4e31ba9), DP_UINT64(0xeb96bf6e, 0xbadf77d9), DP_UINT64(0xaf87023b, 0x9bf0ee6b),
+				};
+				static const short exponents[] = {
+					-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+					-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+					-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+					-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+					56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+					375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+					694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+					1013, 1039, 1066,
+				};
+				//Pick the power which brings the product's exponent into the range digit generation expects
+				const double estimate = (-61 - e) * 0.30102999566398114 + 347;
+				int power = static_cast<int>(estimate);
+				if (estimate - power > 0.0) ++power;
+				const unsigned int index = static_cast<unsigned int>(power >> 3) + 1;
+				k = -(-348 + static_cast<int>(index << 3));
+				return diy_fp(significands[index], exponents[index]);
+			}
+
+			inline int count_decimal_digits(uint32 value) {
+				int digits = 1;
+				for (; value >= 10; value /= 10) ++digits;
+				return digits;
+			}
+
+			//Returns false if the last digit can't be proven closest, or the rounding interval is too narrow to be sure of any digits at all
+			inline bool round_weed(char* buffer, int length, uint64 distance_too_high_w, uint64 unsafe_interval, uint64 rest, uint64 ten_kappa, uint64 unit) {
+				const uint64 small_distance = distance_too_high_w - unit;
+				const uint64 big_distance = distance_too_high_w + unit;
+				//Nudge the last digit down while that moves us closer to the true value and stays within the rounding interval
+				while (rest < small_distance && unsafe_interval - rest >= ten_kappa
+					&& (rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance)) {
+					--buffer[length - 1];
+					rest += ten_kappa;
+				}
+				//If another step down might also be closer, the error in w leaves us unable to choose
+				if (rest < big_distance && unsafe_interval - rest >= ten_kappa
+					&& (rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance)) {
+					return false;
+				}
+				return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+			}
+
+			//low, w and high are the scaled lower boundary, value and upper boundary, each within one unit of the exact product
+			inline bool generate_digits(const diy_fp& low, const diy_fp& w, const diy_fp& high, char* buffer, int& length, int& kappa) {
+				static const uint32 powers_of_ten[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+				uint64 unit = 1;
+				//Widened by the error so that anything outside [too_low, too_high] is certainly outside the true interval
+				const uint64 too_low = low.f - unit;
+				const uint64 too_high = high.f + unit;
+				uint64 unsafe_interval = too_high - too_low;
+				const diy_fp one(static_cast<uint64>(1) << -w.e, w.e);
+				uint32 integral = static_cast<uint32>(too_high >> -one.e);
+				uint64 fractional = too_high & (one.f - 1);
+				kappa = count_decimal_digits(integral);
+				length = 0;
+
+				while (kappa > 0) {
+					const uint32 divisor = powers_of_ten[kappa - 1];
+					buffer[length++] = static_cast<char>('0' + integral / divisor);
+					integral %= divisor;
+					--kappa;
+					const uint64 rest = (static_cast<uint64>(integral) << -one.e) + fractional;
+					if (rest < unsafe_interval) {
+						return round_weed(buffer, length, too_high - w.f, unsafe_interval, rest, static_cast<uint64>(divisor) << -one.e, unit);
+					}
+				}
+
+				for (;;) {
+					fractional *= 10;
+					unit *= 10;
+					unsafe_interval *= 10;
+					buffer[length++] = static_cast<char>('0' + (fractional >> -one.e));
+					fractional &= one.f - 1;
+					--kappa;
+					if (fractional < unsafe_interval) {
+						return round_weed(buffer, length, (too_high - w.f) * unit, unsafe_interval, fractional, one.f, unit);
+					}
+				}
+			}
+
+			//The value's significand and binary exponent, with the hidden bit in place
+			template<typename FloatT>
+			diy_fp decompose(FloatT value) {
+				typedef float_layout<FloatT> layout;
+				typename layout::bits_type bits;
+				std::memcpy(&bits, &value, sizeof(bits));
+
+				const uint64 hidden_bit = static_cast<uint64>(1) << layout::significand_bits;
+				const uint64 significand = static_cast<uint64>(bits) & (hidden_bit - 1);
+				const int biased_exponent = static_cast<int>((bits >> layout::significand_bits) & layout::exponent_mask);
+				return biased_exponent != 0 ? diy_fp(significand + hidden_bit, biased_exponent - layout::exponent_bias) : diy_fp(significand, layout::denormal_exponent);
+			}
+
+			//At a power of two the value below is half as far away as the one above, except at the smallest normal where it is a denormal
+			template<typename FloatT>
+			bool lower_boundary_closer(const diy_fp& v) {
+				return v.f == static_cast<uint64>(1) << float_layout<FloatT>::significand_bits && v.e != float_layout<FloatT>::denormal_exponent;
+			}
+
+			//Grisu3 proper. On success the value is digits * 10^k.
+			template<typename FloatT>
+			bool fast_shortest_digits(FloatT value, char* buffer, int& length, int& k) {
+				const diy_fp v = decompose(value);
+
+				//The halfway points to the neighbouring values
+				const diy_fp upper_boundary = normalize(diy_fp((v.f << 1) + 1, v.e - 1));
+				diy_fp lower_boundary = lower_boundary_closer<FloatT>(v) ? diy_fp((v.f << 2) - 1, v.e - 2) : diy_fp((v.f << 1) - 1, v.e - 1);
+				lower_boundary.f <<= lower_boundary.e - upper_boundary.e;
+				lower_boundary.e = upper_boundary.e;
+
+				int minus_k = 0;
+				const diy_fp power = cached_power(upper_boundary.e, minus_k);
+				const diy_fp w = multiply(normalize(v), power);
+				const diy_fp upper = multiply(upper_boundary, power);
+				const diy_fp lower = multiply(lower_boundary, power);
+				int kappa = 0;
+				const bool exact = generate_digits(lower, w, upper, buffer, length, kappa);
+				k = minus_k + kappa;
+				return exact;
+			}
+
+
+			/*
+			*  The exact fallback. Digits are generated one at a time from the ratio r / s of two bignums, stopping as soon as the digits
+			*  so far identify the value; m_minus and m_plus are the distances to the rounding boundaries on the same scale.
+			*  IEEE round to nearest even reads a boundary back as the even neighbour, so the boundaries count as inside when the significand is even.
+			*/
+			class bignum {
+				enum {
+					//Enough for 10^324 * 2^56, the largest number the fallback works with for double
+					capacity = 40
+				};
+				uint32 words[capacity];
+				int used;
+
+			public:
+				explicit bignum(uint64 value) : used(0) {
+					for (; value != 0; value >>= 32) words[used++] = static_cast<uint32>(value);
+				}
+
+				void multiply(uint32 factor) {
+					uint64 carry = 0;
+					for (int i = 0; i < used; ++i) {
+						const uint64 product = static_cast<uint64>(words[i]) * factor + carry;
+						words[i] = static_cast<uint32>(product);
+						carry = product >> 32;
+					}
+					if (carry != 0) words[used++] = static_cast<uint32>(carry);
+				}
+
+				void multiply_by_power_of_ten(int exponent) {
+					static const uint32 powers_of_ten[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+					for (; exponent >= 9; exponent -= 9) multiply(powers_of_ten[9]);
+					multiply(powers_of_ten[exponent]);
+				}
+
+				void shift_left(int bits) {
+					if (used == 0) return;
+					const int word_shift = bits / 32;
+					const int bit_shift = bits % 32;
+					words[used] = 0;
+					for (int i = used; i >= 0; --i) {
+						const uint32 high = bit_shift != 0 && i > 0 ? words[i - 1] >> (32 - bit_shift) : 0;
+						words[i + word_shift] = (words[i] << bit_shift) | high;
+					}
+					for (int i = 0; i < word_shift; ++i) words[i] = 0;
+					used += word_shift + 1;
+					while (used > 0 && words[used - 1] == 0) --used;
+				}
+
+				void add(const bignum& other) {
+					uint64 carry = 0;
+					for (int i = 0; i < other.used || (carry != 0 && i < used); ++i) {
+						if (i >= used) words[used++] = 0;
+						const uint64 sum = static_cast<uint64>(words[i]) + (i < other.used ? other.words[i] : 0) + carry;
+						words[i] = static_cast<uint32>(sum);
+						carry = sum >> 32;
+					}
+					if (carry != 0) words[used++] = static_cast<uint32>(carry);
+				}
+
+				//Requires *this >= other
+				void subtract(const bignum& other) {
+					uint32 borrow = 0;
+					for (int i = 0; i < used; ++i) {
+						const uint64 subtrahend = static_cast<uint64>(i < other.used ? other.words[i] : 0) + borrow;
+						borrow = words[i] < subtrahend ? 1 : 0;
+						words[i] = static_cast<uint32>(static_cast<uint64>(words[i]) + (static_cast<uint64>(borrow) << 32) - subtrahend);
+					}
+					while (used > 0 && words[used - 1] == 0) --used;
+				}
+
+				bool is_even() const {
+					return used == 0 || (words[0] & 1) == 0;
+				}
+
+				friend int compare(const bignum& lhs, const bignum& rhs) {
+					if (lhs.used != rhs.used) return lhs.used < rhs.used ? -1 : 1;
+					for (int i = lhs.used - 1; i >= 0; --i) {
+						if (lhs.words[i] != rhs.words[i]) return lhs.words[i] < rhs.words[i] ? -1 : 1;
+					}
+					return 0;
+				}
+
+				//Sign of lhs + rhs - other
+				friend int compare_sum(const bignum& lhs, const bignum& rhs, const bignum& other) {
+					bignum sum = lhs;
+					sum.add(rhs);
+					return compare(sum, other);
+				}
+			};
+
+			template<typename FloatT>
+			void exact_shortest_digits(FloatT value, char* buffer, int& length, int& k) {
+				const diy_fp v = decompose(value);
+				//When the boundary below is closer everything is doubled once more, to keep the distance to it whole
+				const bool lower_closer = lower_boundary_closer<FloatT>(v);
+				const bool boundaries_inside = (v.f & 1) == 0;
+
+				bignum r(v.f << (lower_closer ? 2 : 1));
+				bignum s(lower_closer ? 4 : 2);
+				bignum m_minus(1);
+				if (v.e >= 0) {
+					r.shift_left(v.e);
+					m_minus.shift_left(v.e);
+				}
+				else {
+					s.shift_left(-v.e);
+				}
+				bignum m_plus = m_minus;
+				if (lower_closer) m_plus.shift_left(1);
+
+				//An estimate of ceil(log10(value)), which is either right or one too small
+				int bit_length = 0;
+				for (uint64 f = v.f; f != 0; f >>= 1) ++bit_length;
+				const double estimate = (v.e + bit_length - 1) * 0.30102999566398114 - 1e-10;
+				k = static_cast<int>(estimate);
+				if (estimate > 0 && estimate - k > 0.0) ++k;
+				if (k >= 0) {
+					s.multiply_by_power_of_ten(k);
+				}
+				else {
+					r.multiply_by_power_of_ten(-k);
+					m_minus.multiply_by_power_of_ten(-k);
+					m_plus.multiply_by_power_of_ten(-k);
+				}
+				const int high_check = compare_sum(r, m_plus, s);
+				if (boundaries_inside ? high_check >= 0 : high_check > 0) {
+					s.multiply(10);
+					++k;
+				}
+
+				length = 0;
+				for (;;) {
+					r.multiply(10);
+					m_minus.multiply(10);
+					m_plus.multiply(10);
+					int digit = 0;
+					while (compare(r, s) >= 0) {
+						r.subtract(s);
+						++digit;
+					}
+					const int low_check = compare(r, m_minus);
+					const int high_check = compare_sum(r, m_plus, s);
+					const bool low_done = boundaries_inside ? low_check <= 0 : low_check < 0;
+					const bool high_done = boundaries_inside ? high_check >= 0 : high_check > 0;
+					if (!low_done && !high_done) {
+						buffer[length++] = static_cast<char>('0' + digit);
+						continue;
+					}
+					//Either digit would do, so take the closer and on a tie the even one
+					if (low_done && high_done) {
+						const int half_check = compare_sum(r, r, s);
+						if (half_check > 0 || (half_check == 0 && digit % 2 != 0)) ++digit;
+					}
+					else if (high_done) {
+						++digit;
+					}
+					buffer[length++] = static_cast<char>('0' + digit);
+					break;
+				}
+				k -= length;
+			}
+
+			//The shortest digits of a finite, positive value. On return the value is digits * 10^k.
+			template<typename FloatT>
+			void shortest_digits(FloatT value, char* buffer, int& length, int& k) {
+				if (!fast_shortest_digits(value, buffer, length, k)) exact_shortest_digits(value, buffer, length, k);
+			}
+
+			template<typename FloatT>
+			bool sign_bit(FloatT value) {
+				typename float_layout<FloatT>::bits_type bits;
+				std::memcpy(&bits, &value, sizeof(bits));
+				return (bits >> (sizeof(bits) * CHAR_BIT - 1)) != 0;
+			}
+
+			//Two or three exponent digits, as printf and to_chars do
+			inline char* write_exponent(char* out, int exponent) {
+				*out++ = 'e';
+				*out++ = exponent < 0 ? '-' : '+';
+				if (exponent < 0) exponent = -exponent;
+				if (exponent >= 100) {
+					*out++ = static_cast<char>('0' + exponent / 100);
+					exponent %= 100;
+				}
+				*out++ = digit_pairs()[exponent * 2];
+				*out++ = digit_pairs()[exponent * 2 + 1];
+				return out;
+			}
+
+			//Lay out digits * 10^k in whichever of fixed or scientific notation is shorter, preferring fixed, as std::to_chars does.
+			//The one difference is a large whole number in fixed notation, which we pad out with zeroes where to_chars writes its exact digits.
+			inline char* format_digits(char* out, const char* digits, int length, int k) {
+				const int point = length + k;
+				const int exponent = point - 1;
+				const int exponent_length = exponent >= 100 || exponent <= -100 ? 3 : 2;
+				const int scientific_length = length + (length > 1 ? 1 : 0) + 2 + exponent_length;
+				const int fixed_length = k >= 0 ? point : point > 0 ? length + 1 : 2 - point + length;
+
+				if (fixed_length <= scientific_length) {
+					if (k >= 0) {
+						std::memcpy(out, digits, length);
+						std::memset(out + length, '0', k);
+						return out + point;
+					}
+					if (point > 0) {
+						std::memcpy(out, digits, point);
+						out[point] = '.';
+						std::memcpy(out + point + 1, digits + point, length - point);
+						return out + length + 1;
+					}
+					*out++ = '0';
+					*out++ = '.';
+					std::memset(out, '0', -point);
+					std::memcpy(out - point, digits, length);
+					return out - point + length;
+				}
+
+				*out++ = digits[0];
+				if (length > 1) {
+					*out++ = '.';
+					std::memcpy(out, digits + 1, length - 1);
+					out += length - 1;
+				}
+				return write_exponent(out, exponent);
+			}
+
+		}
+
+		enum {
+			//Enough for the longest output of format_floating for float or double
+			max_floating_chars = 32
+		};
+
+		//Writes the shortest representation of the value starting at first, which must have max_floating_chars of space.
+		//Returns one past the last character written.
+		template<typename FloatT>
+		char* format_floating(char* first, FloatT value) {
+			if (value != value) {
+				std::memcpy(first, "nan", 3);
+				return first + 3;
+			}
+			if (grisu::sign_bit(value)) {
+				*first++ = '-';
+				value = -value;
+			}
+			if (value == 0) {
+				*first = '0';
+				return first + 1;
+			}
+			if (value - value != 0) {
+				std::memcpy(first, "inf", 3);
+				return first + 3;
+			}
+			char digits[20];
+			int length = 0;
+			int k = 0;
+			grisu::shortest_digits(value, digits, length, k);
+			return grisu::format_digits(first, digits, length, k);
+		}
+
+		//Formatting to any string type which can be constructed from a range of chars, e.g. std::string and std::wstring
+		template<typename StrT, typename IntT>
+		StrT format_integer_string(IntT in) {
+			char buffer[max_integer_chars];
+			char* const last = buffer + max_integer_chars;
+			const char* const first = format_integer(last, in);
+			return StrT(first, static_cast<const char*>(last));
+		}
+
+		template<typename StrT>
+		StrT format_floating_string(float in) {
+			char buffer[max_floating_chars];
+			const char* const last = format_floating(buffer, in);
+			return StrT(static_cast<const char*>(buffer), last);
+		}
+
+		template<typename StrT>
+		StrT format_floating_string(double in) {
+			char buffer[max_floating_chars];
+			const char* const last = format_floating(buffer, in);
+			return StrT(static_cast<const char*>(buffer), last);
+		}
+
+		template<typename StrT>
+		StrT format_floating_string(long double in) {
+			std::basic_stringstream<typename StrT::value_type> ss;
+			ss << in;
+			return ss.str();
+		}
+
+#undef DP_UINT64
+
+	}
+
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef DP_CI_HASH
+#define DP_CI_HASH
+
+/*
+*  Case-insensitive string hashing for ci_hash. Characters are folded and hashed in the same pass, a word at a time,
+*  so hashing never needs a folded copy of the string.
+*
+*  Narrow text is read eight bytes at a time and ASCII letters are folded within the word, as the fold table does one byte at a time.
+*  Wide characters go through the scalar fold, as beyond Latin-1 that is up to towupper, and are packed two to a word.
+*  Each 16 bytes are mixed with a 64x64->128 bit multiply which folds its halves together, in the style of wyhash.
+*
+*  The value is only stable within one build; it depends on the byte order and, for wide text, on the current locale.
+*
+*  Only included from C++11, where ci_hash is available, but the 64-bit type is spelled as in conv_impl all the same.
+*/
+
+#include <cstddef>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64)) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace dp {
+	namespace ci_impl {
+		namespace hash {
+
+#ifdef __BORLANDC__
+			typedef unsigned __int64 uint64;
+#else
+			typedef unsigned long long uint64;
+#endif
+
+//Spelled this way so we don't need a suffix for 64-bit literals
+#define DP_CI_UINT64(high, low) ((static_cast<dp::ci_impl::hash::uint64>(high) << 32) | static_cast<dp::ci_impl::hash::uint64>(low))
+
+			//Arbitrary odd constants with well spread bits, as wyhash uses
+			static const uint64 seed = DP_CI_UINT64(0xA0761D64, 0x78BD642F);
+			static const uint64 secret_lhs = DP_CI_UINT64(0xE7037ED1, 0xA0B428DB);
+			static const uint64 secret_rhs = DP_CI_UINT64(0x8EBC6AF0, 0x9C88C6E3);
+
+			//The full product of two words, with its high and low halves xored together
+			inline uint64 mum(uint64 lhs, uint64 rhs) {
+#if defined(__SIZEOF_INT128__)
+				__extension__ typedef unsigned __int128 wide_type;
+				const wide_type product = static_cast<wide_type>(lhs) * rhs;
+				return static_cast<uint64>(product) ^ static_cast<uint64>(product >> 64);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64)) && !defined(__clang__)
+				uint64 high;
+				const uint64 low = _umul128(lhs, rhs, &high);
+				return low ^ high;
+#else
+				const uint64 mask = 0xFFFFFFFFu;
+				const uint64 low_low = (lhs & mask) * (rhs & mask);
+				const uint64 high_low = (lhs >> 32) * (rhs & mask);
+				const uint64 low_high = (lhs & mask) * (rhs >> 32);
+				const uint64 high_high = (lhs >> 32) * (rhs >> 32);
+				const uint64 cross = (low_low >> 32) + (high_low & mask) + low_high;
+				const uint64 high = high_high + (high_low >> 32) + (cross >> 32);
+				const uint64 low = (cross << 32) | (low_low & mask);
+				return low ^ high;
+#endif
+			}
+
+			inline uint64 mix(uint64 state, uint64 lhs, uint64 rhs) {
+				return mum(lhs ^ secret_lhs, rhs ^ state);
+			}
+
+			inline uint64 finish(uint64 state, std::size_t length) {
+				return mum(state ^ secret_rhs, static_cast<uint64>(length) ^ secret_lhs);
+			}
+
+			//'A' to 'Z' to lower case in every byte at once. Bit 7 of each sum is set where the low seven bits are at least 'A',
+			//or greater than 'Z'; neither addition can carry into the next byte. Bytes with the top bit set aren't ASCII, so stay as they are.
+			inline uint64 fold_word(uint64 word) {
+				const uint64 high_bits = DP_CI_UINT64(0x80808080, 0x80808080);
+				const uint64 low_bits = word & DP_CI_UINT64(0x7F7F7F7F, 0x7F7F7F7F);
+				const uint64 from_a = low_bits + DP_CI_UINT64(0x3F3F3F3F, 0x3F3F3F3F);
+				const uint64 after_z = low_bits + DP_CI_UINT64(0x25252525, 0x25252525);
+				const uint64 is_upper = from_a & ~after_z & ~word & high_bits;
+				return word | (is_upper >> 2);
+			}
+
+			inline uint64 load_word(const char* in) {
+				uint64 word;
+				std::memcpy(&word, in, sizeof(word));
+				return word;
+			}
+
+			//Fewer than eight bytes, with the rest of the word zero
+			inline uint64 load_partial(const char* in, std::size_t n) {
+				uint64 word = 0;
+				std::memcpy(&word, in, n);
+				return word;
+			}
+
+			inline std::size_t chars(const char* in, std::size_t n) {
+				uint64 state = seed ^ static_cast<uint64>(n);
+				std::size_t i = 0;
+				for (; i + 16 <= n; i += 16) {
+					state = mix(state, fold_word(load_word(in + i)), fold_word(load_word(in + i + 8)));
+				}
+				const std::size_t remaining = n - i;
+				if (remaining > 8) {
+					state = mix(state, fold_word(load_word(in + i)), fold_word(load_partial(in + i + 8, remaining - 8)));
+				}
+				else if (remaining != 0) {
+					state = mix(state, fold_word(load_partial(in + i, remaining)), 0);
+				}
+				return static_cast<std::size_t>(finish(state, n));
+			}
+
+			template<typename Fold>
+			uint64 fold_pair(const wchar_t* in) {
+				return static_cast<uint64>(Fold::apply(in[0]) & 0xFFFFFFFFul) | (static_cast<uint64>(Fold::apply(in[1]) & 0xFFFFFFFFul) << 32);
+			}
+
+			template<typename Fold>
+			std::size_t chars(const wchar_t* in, std::size_t n) {
+				uint64 state = seed ^ static_cast<uint64>(n);
+				std::size_t i = 0;
+				for (; i + 4 <= n; i += 4) {
+					state = mix(state, fold_pair<Fold>(in + i), fold_pair<Fold>(in + i + 2));
+				}
+				const std::size_t remaining = n - i;
+				if (remaining != 0) {
+					const uint64 first = remaining >= 2 ? fold_pair<Fold>(in + i) : Fold::apply(in[i]);
+					const uint64 second = remaining == 3 ? Fold::apply(in[i + 2]) : 0;
+					state = mix(state, first, second);
+				}
+				return static_cast<std::size_t>(finish(state, n));
+			}
+
+		}
+	}
+}
+
+#undef DP_CI_UINT64
+
+#endif
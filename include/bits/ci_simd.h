@@ -0,0 +1,314 @@
+#ifndef DP_CI_SIMD
+#define DP_CI_SIMD
+
+/*
+*  Vectorised kernels for ci_traits::compare and ci_traits::find.
+*  Folding ASCII case is a range check and an OR (or AND-NOT) of 0x20, which we can do for 16 or 32 characters at a time.
+*  A case-insensitive find doesn't need to fold at all; a letter is searched for in both cases at once, as memchr would for one.
+*
+*  SSE2 is part of x86-64, so is always used there. AVX2 is used where the CPU supports it, which is checked once at runtime.
+*  Other platforms, and the Borland compilers, get the scalar loops.
+*  Wide strings are only vectorised where wchar_t is 16 bits, and only across runs of ASCII; anything else is left to the
+*  scalar fold for that character, as towupper can map some characters above Latin-1 onto ASCII letters.
+*
+*  The kernels take the scalar fold as a template parameter, so they fold exactly as ci_traits does.
+*
+*  The group probes for ci_flat_map live here too, as they are the same kind of byte-parallel compare.
+*/
+
+#include <cstddef>
+
+#if !defined(__BORLANDC__) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define DP_CI_SSE2
+#include <emmintrin.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DP_CI_AVX2
+#define DP_CI_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64))
+#define DP_CI_AVX2
+#define DP_CI_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+#endif
+
+namespace dp {
+	namespace ci_impl {
+		namespace simd {
+
+			//The mask must not be zero
+			inline unsigned first_set_bit(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+				return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+				unsigned index = 0;
+				while ((mask & 1) == 0) {
+					mask >>= 1;
+					++index;
+				}
+				return index;
+#endif
+			}
+
+			template<typename Fold, typename CharT>
+			int compare_scalar(const CharT* lhs, const CharT* rhs, std::size_t n) {
+				for (std::size_t i = 0; i < n; ++i) {
+					const unsigned long lhs_folded = Fold::apply(lhs[i]);
+					const unsigned long rhs_folded = Fold::apply(rhs[i]);
+					if (lhs_folded != rhs_folded) return lhs_folded < rhs_folded ? -1 : 1;
+				}
+				return 0;
+			}
+
+			template<typename Fold, typename CharT>
+			const CharT* find_scalar(const CharT* str, std::size_t n, CharT ch) {
+				const unsigned long folded_ch = Fold::apply(ch);
+				for (std::size_t i = 0; i < n; ++i) {
+					if (Fold::apply(str[i]) == folded_ch) return str + i;
+				}
+				return NULL;
+			}
+
+#ifdef DP_CI_SSE2
+
+			//The other case of an ASCII letter, or the character itself
+			inline char other_case(char in) {
+				const unsigned char code = static_cast<unsigned char>(in);
+				return (static_cast<unsigned>((code | 0x20) - 'a') < 26u) ? static_cast<char>(code ^ 0x20) : in;
+			}
+
+			//'A' to 'Z' to lower case. Adding 0x3F moves them to the bottom of the signed range, so one signed compare picks them out.
+			inline __m128i fold_narrow(__m128i in) {
+				const __m128i shifted = _mm_add_epi8(in, _mm_set1_epi8(0x3F));
+				const __m128i is_upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(-128 + 26)));
+				return _mm_or_si128(in, _mm_and_si128(is_upper, _mm_set1_epi8(0x20)));
+			}
+
+			template<typename Fold>
+			int compare_narrow_sse2(const char* lhs, const char* rhs, std::size_t n) {
+				std::size_t i = 0;
+				for (; i + 16 <= n; i += 16) {
+					const __m128i lhs_block = fold_narrow(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i)));
+					const __m128i rhs_block = fold_narrow(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i)));
+					const unsigned equal = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(lhs_block, rhs_block)));
+					if (equal != 0xFFFF) {
+						const std::size_t at = i + first_set_bit(~equal);
+						return Fold::apply(lhs[at]) < Fold::apply(rhs[at]) ? -1 : 1;
+					}
+				}
+				return compare_scalar<Fold>(lhs + i, rhs + i, n - i);
+			}
+
+			inline const char* find_narrow_sse2(const char* str, std::size_t n, char ch) {
+				const __m128i first_case = _mm_set1_epi8(ch);
+				const __m128i second_case = _mm_set1_epi8(other_case(ch));
+				std::size_t i = 0;
+				for (; i + 16 <= n; i += 16) {
+					const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+					const unsigned found = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, first_case), _mm_cmpeq_epi8(block, second_case))));
+					if (found != 0) return str + i + first_set_bit(found);
+				}
+				const char second = other_case(ch);
+				for (; i < n; ++i) {
+					if (str[i] == ch || str[i] == second) return str + i;
+				}
+				return NULL;
+			}
+
+#ifdef DP_CI_AVX2
+
+			inline bool has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+				int info[4];
+				__cpuid(info, 1);
+				//The OS must also save the upper halves of the registers on a context switch
+				const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+				__cpuidex(info, 7, 0);
+				return os_saves_ymm && (info[1] & (1 << 5)) != 0;
+#else
+				return __builtin_cpu_supports("avx2") != 0;
+#endif
+			}
+
+			inline bool use_avx2() {
+				static const bool supported = has_avx2();
+				return supported;
+			}
+
+			DP_CI_TARGET_AVX2 inline __m256i fold_narrow_avx2(__m256i in) {
+				const __m256i shifted = _mm256_add_epi8(in, _mm256_set1_epi8(0x3F));
+				const __m256i is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(-128 + 26)), shifted);
+				return _mm256_or_si256(in, _mm256_and_si256(is_upper, _mm256_set1_epi8(0x20)));
+			}
+
+			template<typename Fold>
+			DP_CI_TARGET_AVX2 int compare_narrow_avx2(const char* lhs, const char* rhs, std::size_t n) {
+				std::size_t i = 0;
+				for (; i + 32 <= n; i += 32) {
+					const __m256i lhs_block = fold_narrow_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i)));
+					const __m256i rhs_block = fold_narrow_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i)));
+					const unsigned equal = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lhs_block, rhs_block)));
+					if (equal != 0xFFFFFFFFu) {
+						const std::size_t at = i + first_set_bit(~equal);
+						return Fold::apply(lhs[at]) < Fold::apply(rhs[at]) ? -1 : 1;
+					}
+				}
+				return compare_narrow_sse2<Fold>(lhs + i, rhs + i, n - i);
+			}
+
+			DP_CI_TARGET_AVX2 inline const char* find_narrow_avx2(const char* str, std::size_t n, char ch) {
+				const __m256i first_case = _mm256_set1_epi8(ch);
+				const __m256i second_case = _mm256_set1_epi8(other_case(ch));
+				std::size_t i = 0;
+				for (; i + 32 <= n; i += 32) {
+					const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+					const unsigned found = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, first_case), _mm256_cmpeq_epi8(block, second_case))));
+					if (found != 0) return str + i + first_set_bit(found);
+				}
+				return find_narrow_sse2(str + i, n - i, ch);
+			}
+
+#endif
+
+			//'a' to 'z' to upper case, which is the direction the wide fold goes
+			inline __m128i fold_wide(__m128i in) {
+				const __m128i shifted = _mm_add_epi16(in, _mm_set1_epi16(static_cast<short>(0x8000 - 'a')));
+				const __m128i is_lower = _mm_cmplt_epi16(shifted, _mm_set1_epi16(static_cast<short>(-32768 + 26)));
+				return _mm_andnot_si128(_mm_and_si128(is_lower, _mm_set1_epi16(0x20)), in);
+			}
+
+			//Runs of ASCII are compared eight at a time. Each time we stop, the scalar fold decides that one character and we carry on after it.
+			template<typename Fold, typename CharT>
+			int compare_wide_sse2(const CharT* lhs, const CharT* rhs, std::size_t n) {
+				const __m128i non_ascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+				const __m128i zero = _mm_setzero_si128();
+				std::size_t i = 0;
+				while (i + 8 <= n) {
+					const __m128i lhs_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+					const __m128i rhs_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+					const __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(lhs_block, rhs_block), non_ascii), zero);
+					const __m128i equal = _mm_and_si128(ascii, _mm_cmpeq_epi16(fold_wide(lhs_block), fold_wide(rhs_block)));
+					const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(equal));
+					if (mask == 0xFFFF) {
+						i += 8;
+						continue;
+					}
+					const std::size_t at = i + first_set_bit(~mask) / 2;
+					const unsigned long lhs_folded = Fold::apply(lhs[at]);
+					const unsigned long rhs_folded = Fold::apply(rhs[at]);
+					if (lhs_folded != rhs_folded) return lhs_folded < rhs_folded ? -1 : 1;
+					i = at + 1;
+				}
+				return compare_scalar<Fold>(lhs + i, rhs + i, n - i);
+			}
+
+			//Only for an ASCII character. We stop at either case of it, or at anything above Latin-1 which might fold onto it.
+			template<typename Fold, typename CharT>
+			const CharT* find_wide_sse2(const CharT* str, std::size_t n, CharT ch) {
+				const char narrow_ch = static_cast<char>(ch);
+				const __m128i first_case = _mm_set1_epi16(static_cast<short>(ch));
+				const __m128i second_case = _mm_set1_epi16(static_cast<short>(other_case(narrow_ch)));
+				const __m128i high = _mm_set1_epi16(static_cast<short>(0xFF00));
+				const __m128i zero = _mm_setzero_si128();
+				const unsigned long folded_ch = Fold::apply(ch);
+				std::size_t i = 0;
+				while (i + 8 <= n) {
+					const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+					const unsigned found = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi16(block, first_case), _mm_cmpeq_epi16(block, second_case))));
+					const unsigned above_latin1 = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(block, high), zero))) & 0xFFFF;
+					const unsigned stop = found | above_latin1;
+					if (stop == 0) {
+						i += 8;
+						continue;
+					}
+					const std::size_t at = i + first_set_bit(stop) / 2;
+					if (Fold::apply(str[at]) == folded_ch) return str + at;
+					i = at + 1;
+				}
+				return find_scalar<Fold>(str + i, n - i, ch);
+			}
+
+#endif
+
+			/*
+			*  Control bytes for ci_flat_map, a group of sixteen at a time. A full slot holds seven bits of its key's hash,
+			*  while empty and deleted slots are negative so a free slot is any with the sign bit set.
+			*  Bit i of each result is set if byte i of the group matches.
+			*/
+			static const std::size_t group_size = 16;
+
+			inline unsigned match_control(const signed char* group, signed char value) {
+#if defined(DP_CI_SSE2)
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+				return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(value))));
+#else
+				unsigned mask = 0;
+				for (std::size_t i = 0; i < group_size; ++i) {
+					if (group[i] == value) mask |= 1u << i;
+				}
+				return mask;
+#endif
+			}
+
+			inline unsigned match_free(const signed char* group) {
+#if defined(DP_CI_SSE2)
+				return static_cast<unsigned>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+#else
+				unsigned mask = 0;
+				for (std::size_t i = 0; i < group_size; ++i) {
+					if (group[i] < 0) mask |= 1u << i;
+				}
+				return mask;
+#endif
+			}
+
+			template<typename Fold>
+			int compare(const char* lhs, const char* rhs, std::size_t n) {
+#if defined(DP_CI_AVX2)
+				if (use_avx2()) return compare_narrow_avx2<Fold>(lhs, rhs, n);
+#endif
+#if defined(DP_CI_SSE2)
+				return compare_narrow_sse2<Fold>(lhs, rhs, n);
+#else
+				return compare_scalar<Fold>(lhs, rhs, n);
+#endif
+			}
+
+			template<typename Fold>
+			const char* find(const char* str, std::size_t n, char ch) {
+#if defined(DP_CI_AVX2)
+				if (use_avx2()) return find_narrow_avx2(str, n, ch);
+#endif
+#if defined(DP_CI_SSE2)
+				return find_narrow_sse2(str, n, ch);
+#else
+				return find_scalar<Fold>(str, n, ch);
+#endif
+			}
+
+			template<typename Fold>
+			int compare(const wchar_t* lhs, const wchar_t* rhs, std::size_t n) {
+#if defined(DP_CI_SSE2)
+				if (sizeof(wchar_t) == 2) return compare_wide_sse2<Fold>(lhs, rhs, n);
+#endif
+				return compare_scalar<Fold>(lhs, rhs, n);
+			}
+
+			template<typename Fold>
+			const wchar_t* find(const wchar_t* str, std::size_t n, wchar_t ch) {
+#if defined(DP_CI_SSE2)
+				if (sizeof(wchar_t) == 2 && static_cast<unsigned long>(ch) < 0x80) return find_wide_sse2<Fold>(str, n, ch);
+#endif
+				return find_scalar<Fold>(str, n, ch);
+			}
+
+		}
+	}
+}
+
+#undef DP_CI_TARGET_AVX2
+
+#endif
@@ -13,9 +13,20 @@
 #include <cmath>
 #include <limits>
 #include <array>
+#include <vector>
+#include <cstdint>
+#include <iterator>
+#include <tuple>
+#include <bitset>
+#include <utility>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 #include "bits/borland_version_defs.h"
 #include "bits/tmp_tags.h"
+#include "bits/charconv_cpp17.h"
+#include "bits/utf_cpp17.h"
 
 #include "contracts.h"
 
@@ -42,6 +53,12 @@
 #define CHARCONV_CONSTEXPR
 #endif
 
+#ifdef __cpp_consteval
+#define DP_CONSTEVAL consteval
+#else
+#define DP_CONSTEVAL constexpr
+#endif
+
 namespace dp {
 
 	//Forward dec
@@ -49,6 +66,122 @@ namespace dp {
 	constexpr To convert_to(const From&);
 
 
+	/*
+	*  The error channel for try_convert_to. Failed conversions are reported by value rather than through the contract machinery,
+	*  so a parse loop which expects bad data need never touch the heap or the exception machinery.
+	*/
+	enum class conversion_error {
+		none,
+		invalid_input,
+		out_of_range
+	};
+
+	template<typename T>
+	class conversion_result {
+		T val{};
+		conversion_error err{ conversion_error::none };
+		std::size_t pos{ 0 };
+
+	public:
+		constexpr conversion_result(T in_val, std::size_t in_pos) : val{ in_val }, pos{ in_pos } {}
+		constexpr conversion_result(conversion_error in_err, std::size_t in_pos) : err{ in_err }, pos{ in_pos } {}
+
+		constexpr bool has_value() const {
+			return err == conversion_error::none;
+		}
+
+		constexpr explicit operator bool() const {
+			return has_value();
+		}
+
+		//Accessing the value of a failed conversion is a contract violation
+		constexpr const T& value() const {
+			dp::contract_assert(has_value(), "Attempt to access the value of a failed conversion");
+			return val;
+		}
+
+		//Unchecked access. A failed conversion holds a value-initialized T
+		constexpr const T& operator*() const {
+			return val;
+		}
+
+		constexpr T value_or(T default_value) const {
+			return has_value() ? val : default_value;
+		}
+
+		constexpr conversion_error error() const {
+			return err;
+		}
+
+		//On success, the number of characters consumed. On failure, the position of the offending character.
+		constexpr std::size_t position() const {
+			return pos;
+		}
+	};
+
+
+	/*
+	*  The base in which to read an integer. With detect, a prefix of 0x, 0b or 0o (in either case) selects hex, binary or octal,
+	*  as do the # and Delphi-style $ prefixes for hex. Anything else, including a leading 0, is decimal.
+	*  The explicit bases also accept their own prefix, so convert_to<int>("$FF", radix::hex) is fine.
+	*  In every case a '-' comes before the prefix, and a prefix only counts if a valid digit follows it.
+	*/
+	enum class radix {
+		detect,
+		dec,
+		hex,
+		bin,
+		oct
+	};
+
+
+	/*
+	*  Formatting options for converting a floating point value to a string. Without one, the output is the shortest form which reads back exactly.
+	*  With one, the output is that of std::to_chars with the given format and precision, so convert_to<std::string>(x, dp::fmt::fixed{2})
+	*  gives the same text as printf's %.2f, without printf's locale.
+	*/
+	namespace fmt {
+		struct spec {
+			std::chars_format format;
+			int precision;
+		};
+
+		struct fixed : spec {
+			constexpr explicit fixed(int in_precision = 6) : spec{ std::chars_format::fixed, in_precision } {}
+		};
+
+		struct scientific : spec {
+			constexpr explicit scientific(int in_precision = 6) : spec{ std::chars_format::scientific, in_precision } {}
+		};
+
+		struct general : spec {
+			constexpr explicit general(int in_precision = 6) : spec{ std::chars_format::general, in_precision } {}
+		};
+	}
+
+
+	/*
+	*  Opt-in conversion between enums and their names. Specialise enum_names for your enum with a static constexpr array of entries:
+	* 
+	*  template<> struct dp::enum_names<colour> {
+	*      static constexpr dp::enum_entry<colour> entries[]{ { "red", colour::red }, { "green", colour::green } };
+	*      using traits_type = dp::ci_char_traits;	//Optional, for case-insensitive matching
+	*  };
+	* 
+	*  convert_to<colour>(std::string_view) and convert_to<std::string_view>(colour) then go through perfect hash tables built at compile time,
+	*  so each is a single hash and comparison regardless of how many names there are. A traits_type which ignores case must only ignore ASCII case.
+	*  Several names may share a value; converting that value to a string gives the first of them.
+	*/
+	template<typename E>
+	struct enum_entry {
+		std::string_view name;
+		E value;
+	};
+
+	template<typename E>
+	struct enum_names;
+
+
 	//Implementation tools. Do not touch these in user code.
 	namespace conv_impl {
 
@@ -67,6 +200,346 @@ namespace dp {
 		template<typename>
 		constexpr inline bool dependent_false{ false };
 
+		/*
+		*  The non-throwing parsing cores. These do the actual work of reading a number out of a narrow string and report failure
+		*  in the same way as std::from_chars; leaving it to the caller to decide whether that failure is a contract violation (convert_to)
+		*  or just something to be recorded (convert_range).
+		*/
+		//Skips past any prefix which is valid for the requested radix, and returns the base of the digits which follow
+		template<typename CharT>
+		constexpr unsigned strip_radix_prefix(const CharT*& first, const CharT* last, radix base) {
+			unsigned prefix_base{ 10 };
+			std::ptrdiff_t prefix_length{ 0 };
+			if (last - first >= 2 && (first[0] == CharT('#') || first[0] == CharT('$'))) {
+				prefix_base = 16;
+				prefix_length = 1;
+			}
+			else if (last - first >= 3 && first[0] == CharT('0')) {
+				switch (static_cast<std::uint32_t>(first[1]) | 0x20) {
+				case 'x': prefix_base = 16; prefix_length = 2; break;
+				case 'b': prefix_base = 2; prefix_length = 2; break;
+				case 'o': prefix_base = 8; prefix_length = 2; break;
+				default: break;
+				}
+			}
+
+			const unsigned requested{ base == radix::hex ? 16u : base == radix::bin ? 2u : base == radix::oct ? 8u : 10u };
+			if (base != radix::detect && prefix_base != requested) return requested;
+			if (prefix_length != 0 && lookup_digit(first[prefix_length]) < prefix_base) {
+				first += prefix_length;
+				return prefix_base;
+			}
+			return requested;
+		}
+
+		//Integer parsing in any radix, for any character type. Decimal goes through the fastest kernel available.
+		template<typename T, typename CharT>
+		parse_result<CharT> parse_integer_radix(const CharT* first, const CharT* last, T& out, radix base) {
+			const CharT* ptr{ first };
+			bool negative{ false };
+			if constexpr (std::is_signed_v<T>) {
+				if (ptr != last && *ptr == CharT('-')) {
+					negative = true;
+					++ptr;
+				}
+			}
+			const unsigned digit_base{ strip_radix_prefix(ptr, last, base) };
+
+			if constexpr (has_fast_decimal<T>) {
+				if (digit_base == 10) {
+					if constexpr (std::is_same_v<CharT, char>) {
+						const auto result{ parse_decimal(first, last, out) };
+						return { result.ptr, result.ec };
+					}
+					else {
+						return parse_integer_chars(first, last, out);
+					}
+				}
+				const unsigned bits_per_digit{ digit_base == 16 ? 4u : digit_base == 8 ? 3u : 1u };
+				const auto result{ parse_power_of_two_radix(ptr, last, bits_per_digit, negative, out) };
+				if (result.ec == std::errc::invalid_argument) return { first, result.ec };
+				return result;
+			}
+			else {
+				//Wider than we have kernels for, so leave it to the standard library
+				static_assert(std::is_same_v<CharT, char>, "Integer parsing from wide strings is only supported on integral types of 64 bits or fewer");
+				if (digit_base == 10) {
+					const auto result{ std::from_chars(first, last, out) };
+					return { result.ptr, result.ec };
+				}
+				T magnitude{};
+				const auto result{ std::from_chars(ptr, last, magnitude, static_cast<int>(digit_base)) };
+				if (result.ec == std::errc::invalid_argument) return { first, result.ec };
+				//from_chars has no way to parse a negative magnitude, so the most negative value is out of reach
+				if (result.ec == std::errc{}) out = negative ? static_cast<T>(-magnitude) : magnitude;
+				return { result.ptr, result.ec };
+			}
+		}
+
+		template<typename T>
+		std::from_chars_result parse_integer(std::string_view in, T& out, radix base = radix::detect) {
+			const auto result{ parse_integer_radix(in.data(), in.data() + in.length(), out, base) };
+			return { result.ptr, result.ec };
+		}
+
+		template<typename T>
+		CHARCONV_CONSTEXPR std::from_chars_result parse_floating(std::string_view in, T& out) {
+			//Not every compiler supports floating point from_chars (looking at you Embarcadero)
+			//But where we can have it we want it.
+			if constexpr (from_chars_exists<T>) {
+				return std::from_chars(in.data(), in.data() + in.length(), out);
+			}
+			//Otherwise we use our own, rather than strtod which is locale dependent and can't respect the length of a string_view
+			else {
+				const auto result{ parse_floating_chars(in.data(), in.data() + in.length(), out) };
+				return { result.ptr, result.ec };
+			}
+		}
+
+		template<typename T, typename CharT>
+		constexpr conversion_result<T> make_result(T value, const CharT* begin, const CharT* end, std::errc ec) {
+			if (ec == std::errc::invalid_argument) return { conversion_error::invalid_input, static_cast<std::size_t>(end - begin) };
+			if (ec == std::errc::result_out_of_range) return { conversion_error::out_of_range, static_cast<std::size_t>(end - begin) };
+			return { value, static_cast<std::size_t>(end - begin) };
+		}
+
+		//Deliberately literals; we don't want to allocate just to report an error
+		constexpr std::string_view integer_error_message(conversion_error err) {
+			return err == conversion_error::out_of_range ? "Error converting to integer type: out of range" : "Error converting to integer type: invalid input";
+		}
+
+		constexpr std::string_view floating_error_message(conversion_error err) {
+			return err == conversion_error::out_of_range ? "Error converting to floating point: out of range" : "Error converting to floating point: invalid input";
+		}
+
+		constexpr std::string_view bool_error_message() {
+			return "Error converting to bool: invalid input";
+		}
+
+		constexpr std::string_view enum_error_message() {
+			return "Error converting to enum type: no matching name";
+		}
+
+
+		template<typename E, typename = void>
+		struct has_enum_names_impl : std::false_type {};
+
+		template<typename E>
+		struct has_enum_names_impl<E, std::void_t<decltype(enum_names<E>::entries)>> : std::is_enum<E> {};
+
+		template<typename E>
+		static constexpr inline bool has_enum_names = has_enum_names_impl<E>::value;
+
+		template<typename E, typename = void>
+		struct enum_traits_type {
+			using type = std::char_traits<char>;
+		};
+
+		template<typename E>
+		struct enum_traits_type<E, std::void_t<typename enum_names<E>::traits_type>> {
+			using type = typename enum_names<E>::traits_type;
+		};
+
+		//The tag for any enum which has names to convert to
+		struct tag_named_enum {
+			template<typename E, std::enable_if_t<has_enum_names<E>, int> = 0>
+			constexpr tag_named_enum(instance_of<E>) {}
+		};
+
+		//FNV-1a over the characters, with 'A' to 'Z' folded to lower case when matching is case insensitive.
+		//Only those, as ci_char_traits folds nothing else; folding more would give names it tells apart the same hash.
+		template<bool FoldCase, typename CharT>
+		constexpr std::uint64_t hash_name(const CharT* first, const CharT* last) {
+			std::uint64_t hash{ 0xcbf29ce484222325ull };
+			for (; first != last; ++first) {
+				auto code{ static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<CharT>>(*first)) };
+				if constexpr (FoldCase) {
+					if (code - 'A' < 26) code |= 0x20;
+				}
+				hash = (hash ^ code) * 0x100000001b3ull;
+			}
+			return hash;
+		}
+
+		//The MurmurHash3 finaliser, so every bit of the key affects the low bits we take for the index
+		constexpr std::uint64_t mix_hash(std::uint64_t hash) {
+			hash = (hash ^ (hash >> 33)) * 0xff51afd7ed558ccdull;
+			hash = (hash ^ (hash >> 33)) * 0xc4ceb9fe1a85ec53ull;
+			return hash ^ (hash >> 33);
+		}
+
+		constexpr std::size_t next_power_of_two(std::size_t in) {
+			std::size_t out{ 1 };
+			while (out < in) out *= 2;
+			return out;
+		}
+
+		/*
+		*  A minimal perfect hash, by hash-and-displace. Keys are first split into buckets; then, fullest bucket first, each bucket is given
+		*  the smallest displacement which sends all of its keys to empty slots. A lookup is one bucket read and one slot read, and the slot
+		*  holds the index of the only key which could possibly match, so the caller need only compare against that.
+		*/
+		template<std::size_t N>
+		struct perfect_hash {
+			static constexpr std::size_t bucket_count{ next_power_of_two(N) };
+			static constexpr std::size_t slot_count{ bucket_count * 2 };
+			//Marks an empty slot
+			static constexpr std::size_t npos{ N };
+
+			std::array<std::uint32_t, bucket_count> displacement{};
+			std::array<std::size_t, slot_count> slots{};
+
+			static constexpr std::size_t bucket_of(std::uint64_t hash) {
+				return static_cast<std::size_t>(mix_hash(hash) & (bucket_count - 1));
+			}
+
+			static constexpr std::size_t slot_of(std::uint64_t hash, std::uint32_t disp) {
+				return static_cast<std::size_t>(mix_hash(hash + (disp + 1) * 0x9e3779b97f4a7c15ull) & (slot_count - 1));
+			}
+
+			//The index of the only key which could have this hash, or npos
+			constexpr std::size_t find(std::uint64_t hash) const {
+				return slots[slot_of(hash, displacement[bucket_of(hash)])];
+			}
+		};
+
+		//Keys which are not included (e.g. the second name for the same value) are left out of the table
+		template<std::size_t N>
+		constexpr perfect_hash<N> make_perfect_hash(const std::array<std::uint64_t, N>& hashes, const std::array<bool, N>& included) {
+			using table_type = perfect_hash<N>;
+			table_type table{};
+			for (auto& slot : table.slots) slot = table_type::npos;
+
+			//Sort the keys by bucket, so each attempt at placing a bucket only looks at its own keys
+			std::array<std::size_t, table_type::bucket_count + 1> bucket_begin{};
+			std::size_t largest{ 0 };
+			for (std::size_t i = 0; i < N; ++i) {
+				if (included[i]) ++bucket_begin[table_type::bucket_of(hashes[i]) + 1];
+			}
+			for (std::size_t b = 0; b < table_type::bucket_count; ++b) {
+				largest = (std::max)(largest, bucket_begin[b + 1]);
+				bucket_begin[b + 1] += bucket_begin[b];
+			}
+			std::array<std::size_t, N> members{};
+			std::array<std::size_t, table_type::bucket_count> filled{};
+			for (std::size_t i = 0; i < N; ++i) {
+				if (!included[i]) continue;
+				const auto bucket{ table_type::bucket_of(hashes[i]) };
+				members[bucket_begin[bucket] + filled[bucket]++] = i;
+			}
+
+			std::array<std::size_t, N> placed{};
+			for (std::size_t size = largest; size > 0; --size) {
+				for (std::size_t bucket = 0; bucket < table_type::bucket_count; ++bucket) {
+					const auto first{ bucket_begin[bucket] };
+					if (bucket_begin[bucket + 1] - first != size) continue;
+
+					//Two keys with the same hash could never be told apart, and always land in the same bucket
+					for (std::size_t i = 0; i < size; ++i) {
+						for (std::size_t j = i + 1; j < size; ++j) {
+							dp::contract_assert(hashes[members[first + i]] != hashes[members[first + j]], "Error in enum_names: duplicate name");
+						}
+					}
+
+					for (std::uint32_t disp = 0; ; ++disp) {
+						bool fits{ true };
+						for (std::size_t i = 0; i < size && fits; ++i) {
+							placed[i] = table_type::slot_of(hashes[members[first + i]], disp);
+							fits = table.slots[placed[i]] == table_type::npos;
+							for (std::size_t j = 0; j < i && fits; ++j) fits = placed[j] != placed[i];
+						}
+						if (!fits) continue;
+
+						table.displacement[bucket] = disp;
+						for (std::size_t i = 0; i < size; ++i) table.slots[placed[i]] = members[first + i];
+						break;
+					}
+				}
+			}
+			return table;
+		}
+
+		//The tables for a particular enum, built once at compile time
+		template<typename E>
+		struct enum_lookup {
+			using traits_type = typename enum_traits_type<E>::type;
+			using underlying_type = std::underlying_type_t<E>;
+			static_assert(std::is_same_v<typename traits_type::char_type, char>, "The traits_type of enum_names must be for char");
+
+			static constexpr std::size_t size{ std::size(enum_names<E>::entries) };
+			static_assert(size > 0, "enum_names must have at least one entry");
+			static constexpr bool fold_case{ traits_type::eq('a', 'A') };
+
+			static constexpr const enum_entry<E>& entry(std::size_t index) {
+				return enum_names<E>::entries[index];
+			}
+
+			static constexpr std::uint64_t hash_value(E value) {
+				return static_cast<std::uint64_t>(static_cast<underlying_type>(value));
+			}
+
+			static constexpr perfect_hash<size> make_name_table() {
+				std::array<std::uint64_t, size> hashes{};
+				std::array<bool, size> included{};
+				for (std::size_t i = 0; i < size; ++i) {
+					hashes[i] = hash_name<fold_case>(entry(i).name.data(), entry(i).name.data() + entry(i).name.size());
+					included[i] = true;
+				}
+				return make_perfect_hash(hashes, included);
+			}
+
+			static constexpr perfect_hash<size> make_value_table() {
+				std::array<std::uint64_t, size> hashes{};
+				std::array<bool, size> included{};
+				for (std::size_t i = 0; i < size; ++i) {
+					hashes[i] = hash_value(entry(i).value);
+					included[i] = true;
+					for (std::size_t j = 0; j < i && included[i]; ++j) included[i] = entry(j).value != entry(i).value;
+				}
+				return make_perfect_hash(hashes, included);
+			}
+
+			static constexpr perfect_hash<size> by_name{ make_name_table() };
+			static constexpr perfect_hash<size> by_value{ make_value_table() };
+
+			//Wide input only matches where every character is ASCII
+			template<typename CharT>
+			static constexpr bool name_matches(std::string_view name, const CharT* first, const CharT* last) {
+				if (name.size() != static_cast<std::size_t>(last - first)) return false;
+				if constexpr (std::is_same_v<CharT, char>) {
+					return traits_type::compare(name.data(), first, name.size()) == 0;
+				}
+				else {
+					for (std::size_t i = 0; i < name.size(); ++i) {
+						const auto code{ static_cast<std::uint32_t>(first[i]) };
+						if (code >= 0x80 || !traits_type::eq(static_cast<char>(code), name[i])) return false;
+					}
+					return true;
+				}
+			}
+
+			template<typename CharT>
+			static constexpr const enum_entry<E>* find(const CharT* first, const CharT* last) {
+				const auto index{ by_name.find(hash_name<fold_case>(first, last)) };
+				if (index == perfect_hash<size>::npos || !name_matches(entry(index).name, first, last)) return nullptr;
+				return &entry(index);
+			}
+
+			static constexpr const enum_entry<E>* find(E value) {
+				const auto index{ by_value.find(hash_value(value)) };
+				if (index == perfect_hash<size>::npos || entry(index).value != value) return nullptr;
+				return &entry(index);
+			}
+		};
+
+		template<typename E>
+		inline std::string_view enum_name(E value) {
+			const auto found{ enum_lookup<E>::find(value) };
+			CONTRACT_ASSERT(found != nullptr, "Error converting enum to string: value has no name");
+			return found != nullptr ? found->name : std::string_view{};
+		}
+
+
 		template<typename T, typename = void>
 		struct conv_helper {
 			static_assert(dependent_false<T>, "Attempting to convert to invalid type");
@@ -74,7 +547,7 @@ namespace dp {
 
 		//INTEGER
 		template<typename T>
-		struct conv_helper<T, std::enable_if_t<std::is_integral_v<T>>> {
+		struct conv_helper<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
 
 			//INT
 			template<typename IntT>
@@ -93,49 +566,69 @@ namespace dp {
 				return in ? 1 : 0;
 			}
 			//STRINGS
-			CHARCONV_CONSTEXPR static inline T get(std::string_view in, tag_narrow_string) {
-				//Fortunately integral from_chars is supported on all major platforms
-				//Check for hex formatting
-				int base{ 10 };
-				if (in.length() >= 2 && in[0] == '0' && in[1] == 'x') {
-					base = 16;
-					in.remove_prefix(2);
-				}
+			static inline conversion_result<T> try_get(std::string_view in, tag_narrow_string, radix base = radix::detect) {
 				T out{};
-				auto result{ std::from_chars(in.data(), in.data() + in.length(), out, base) };
-				CONTRACT_ASSERT(result.ec == std::errc{}, std::string{ "Error converting to integer type: " } + (result.ec == std::errc::invalid_argument ? " invalid input" : " out of range"));
-				return out;
-				
+				auto result{ parse_integer(in, out, base) };
+				return make_result(out, in.data(), result.ptr, result.ec);
+			}
+			static inline T get(std::string_view in, tag_narrow_string, radix base = radix::detect) {
+				const auto result{ try_get(in, tag_narrow_string{}, base) };
+				CONTRACT_ASSERT(result.has_value(), integer_error_message(result.error()));
+				return *result;
 			}
 			//WIDESTRINGS
-			static inline T get(std::wstring_view in, tag_wide_string) {
-				int base{ 10 };
-				if (in.length() >= 2 && in[0] == L'0' && in[1] == L'x') {
-					base = 16;
-					in.remove_prefix(2);
-				}
+			static inline conversion_result<T> try_get(std::wstring_view in, tag_wide_string, radix base = radix::detect) {
+				T out{};
+				auto result{ parse_integer_radix(in.data(), in.data() + in.length(), out, base) };
+				return make_result(out, in.data(), result.ptr, result.ec);
+			}
+			static inline T get(std::wstring_view in, tag_wide_string, radix base = radix::detect) {
+				const auto result{ try_get(in, tag_wide_string{}, base) };
+				CONTRACT_ASSERT(result.has_value(), integer_error_message(result.error()));
+				return *result;
+			}
+		};
 
-				T result{};
-				wchar_t* end{};
-				if constexpr (std::is_unsigned_v<T>) {
-					if constexpr (std::is_same_v<T, unsigned long long>) {
-						result = std::wcstoull(in.data(), &end, base);
-					}
-					else {
-						result = std::wcstoul(in.data(), &end, base);
-					}
-				}
-				else {
-					if constexpr (std::is_same_v<T, long long>) {
-						result = std::wcstoll(in.data(), &end, base);
-					}
-					else {
-						result = std::wcstol(in.data(), &end, base);
-					}
-				}
-				CONTRACT_ASSERT(result != HUGE_VALF && result != HUGE_VAL && result != HUGE_VALL, "Error converting to integer type: Out of range");
-				CONTRACT_ASSERT(result != 0 || end != in.data(), "Error converting to integer type: Invalid input");
-				return result;
+		//BOOL
+		template<typename T>
+		struct conv_helper<T, std::enable_if_t<std::is_same_v<T, bool>>> {
+
+			//INT
+			template<typename IntT>
+			constexpr static inline T get(IntT in, tag_any_int) {
+				return in != 0;
+			}
+			//FLOAT
+			template<typename FloatT>
+			constexpr static inline T get(FloatT in, tag_floating_point) {
+				return in != 0;
+			}
+			//BOOL
+			constexpr static inline T get(bool in, instance_of<bool>) {
+				return in;
+			}
+			//STRINGS
+			//Accepts true/false, yes/no in any case, or 1/0. Anything else, including surrounding whitespace, is invalid input.
+			static inline conversion_result<T> try_get(std::string_view in, tag_narrow_string) {
+				bool out{};
+				auto result{ parse_bool_chars(in.data(), in.data() + in.length(), out) };
+				return make_result(out, in.data(), result.ptr, result.ec);
+			}
+			static inline T get(std::string_view in, tag_narrow_string) {
+				const auto result{ try_get(in, tag_narrow_string{}) };
+				CONTRACT_ASSERT(result.has_value(), bool_error_message());
+				return *result;
+			}
+			//WIDESTRINGS
+			static inline conversion_result<T> try_get(std::wstring_view in, tag_wide_string) {
+				bool out{};
+				auto result{ parse_bool_chars(in.data(), in.data() + in.length(), out) };
+				return make_result(out, in.data(), result.ptr, result.ec);
+			}
+			static inline T get(std::wstring_view in, tag_wide_string) {
+				const auto result{ try_get(in, tag_wide_string{}) };
+				CONTRACT_ASSERT(result.has_value(), bool_error_message());
+				return *result;
 			}
 		};
 
@@ -159,53 +652,87 @@ namespace dp {
 			}
 
 			//STRING TYPES
+			CHARCONV_CONSTEXPR static inline conversion_result<T> try_get(std::string_view in, tag_narrow_string) {
+				T out{};
+				auto result{ parse_floating(in, out) };
+				return make_result(out, in.data(), result.ptr, result.ec);
+			}
 			CHARCONV_CONSTEXPR static inline T get(std::string_view in, tag_narrow_string) {
-				//Not every compiler supports floating point from_chars (looking at you Embarcadero)
-				//But where we can have it we want it.
-				if constexpr (from_chars_exists<T>) {
-					T out;
-					auto result{ std::from_chars(in.data(), in.data() + in.length(), out) };
-					CONTRACT_ASSERT(result.ec == std::errc{}, std::string{ "Error converting to floating point: " } + (result.ec == std::errc::invalid_argument ? " invalid input" : " out of range"));
-					return out;
-				}
-				else {
-					char* end{};
-					T result{};
-					if constexpr (std::is_same_v<T, float>) {
-						result = std::strtof(in.data(), &end);
-					}
-					else if constexpr (std::is_same_v<T, double>) {
-						result = std::strtod(in.data(), &end);
-					}
-					else {
-						result = strtold(in.data(), &end);
-					}
-					CONTRACT_ASSERT(result != HUGE_VALF && result != HUGE_VAL && result != HUGE_VALL, "Error converting to floating point: out of range");
-					CONTRACT_ASSERT(result != 0 || end != in.data(), "Error converting to floating point: invalid input");
-					return result;
-				}
+				const auto result{ try_get(in, tag_narrow_string{}) };
+				CONTRACT_ASSERT(result.has_value(), floating_error_message(result.error()));
+				return *result;
 			}
 
 			//WIDESTRING TYPES
+			static inline conversion_result<T> try_get(std::wstring_view in, tag_wide_string) {
+				//No from_chars support here, so we use our own parser. Which, unlike wcstod, respects the length of the view
+				T out{};
+				auto result{ parse_floating_chars(in.data(), in.data() + in.length(), out) };
+				return make_result(out, in.data(), result.ptr, result.ec);
+			}
 			static inline T get(std::wstring_view in, tag_wide_string) {
-				//No from chars support here
-				wchar_t* end{};
-				T result{};
-				if constexpr (std::is_same_v<T, float>) {
-					result = std::wcstof(in.data(), &end);
-				}
-				else if constexpr (std::is_same_v<T, double>) {
-					result = std::wcstod(in.data(), &end);
-				}
-				else {
-					result = std::wcstold(in.data(), &end);
-				}
-				CONTRACT_ASSERT(result != HUGE_VALF && result != HUGE_VAL && result != HUGE_VALL, "Error converting to floating point: out of range");
-				CONTRACT_ASSERT(result != 0 || end != in.data(), "Error converting to floating point: invalid input");
-				return result;
+				const auto result{ try_get(in, tag_wide_string{}) };
+				CONTRACT_ASSERT(result.has_value(), floating_error_message(result.error()));
+				return *result;
 			}
 		};
 
+		//Enough room for the shortest round-trip form of any value: sign, significant digits, decimal point, and a signed exponent
+		template<typename FloatT>
+		static constexpr inline std::size_t float_buffer_size{ std::numeric_limits<FloatT>::max_digits10 + 10 };
+
+		//to_chars output is plain ASCII, so widening is a straight copy. Kept as a simple loop so the compiler can vectorise it.
+		template<typename CharT>
+		inline void widen(const char* first, const char* last, CharT* out) {
+			for (; first != last; ++first, ++out) {
+				*out = static_cast<CharT>(*first);
+			}
+		}
+
+		//Format with to_chars into a stack buffer then widen straight into the result, so we only allocate once.
+		template<typename StrT, std::size_t BufferSize, typename Number>
+		inline StrT to_wide_string(Number in) {
+			std::array<char, BufferSize> buffer;
+			const auto result{ std::to_chars(buffer.data(), buffer.data() + buffer.size(), in) };
+			if (result.ec == std::errc::value_too_large) CONTRACT_ASSERT(false, "Error converting to std::wstring: input too large");
+			StrT out(static_cast<std::size_t>(result.ptr - buffer.data()), typename StrT::value_type{});
+			widen(buffer.data(), result.ptr, out.data());
+			return out;
+		}
+
+		//The length is known before any digits are written, so the string is allocated once at its final size and written in place
+		template<typename StrT, typename IntT>
+		inline StrT to_decimal_string(IntT in) {
+			const auto length{ decimal_length(in) };
+			StrT out(length, typename StrT::value_type{});
+			write_decimal(out.data(), length, in);
+			return out;
+		}
+
+		//The most characters a value can take in the given format: sign, digits, decimal point and exponent.
+		//Only fixed can get long, as every digit before the point of a large value is written out.
+		template<typename FloatT>
+		constexpr std::size_t max_formatted_chars(fmt::spec spec) {
+			const auto precision{ static_cast<std::size_t>(spec.precision) };
+			if (spec.format == std::chars_format::fixed) return precision + std::numeric_limits<FloatT>::max_exponent10 + 4;
+			return precision + 10;
+		}
+
+		//Formats the value according to the spec, and passes the text to the sink as a pair of pointers.
+		//Almost everything fits in a stack buffer; a large value in fixed notation gets one sized for the worst case.
+		template<typename FloatT, typename Sink>
+		inline decltype(auto) format_floating(FloatT in, fmt::spec spec, Sink&& sink) {
+			CONTRACT_ASSERT(spec.precision >= 0, "Error formatting floating point value: precision cannot be negative");
+			std::array<char, 64> buffer;
+			auto result{ std::to_chars(buffer.data(), buffer.data() + buffer.size(), in, spec.format, spec.precision) };
+			if (result.ec == std::errc{}) return sink(static_cast<const char*>(buffer.data()), static_cast<const char*>(result.ptr));
+
+			std::vector<char> large(max_formatted_chars<FloatT>(spec));
+			result = std::to_chars(large.data(), large.data() + large.size(), in, spec.format, spec.precision);
+			if (result.ec == std::errc::value_too_large) CONTRACT_ASSERT(false, "Error formatting floating point value: input too large");
+			return sink(static_cast<const char*>(large.data()), static_cast<const char*>(result.ptr));
+		}
+
 		template<typename T>
 		static constexpr inline bool is_owning_narrow_string = std::is_same_v<T, std::string>
 #ifdef DP_CBUILDER11
@@ -223,25 +750,58 @@ namespace dp {
 			}
 			//INTEGER TYPES
 			template<typename IntT>
-			CHARCONV_CONSTEXPR static inline T get(IntT in, tag_any_int) {
-				std::array<char, std::numeric_limits<IntT>::digits + 1> arr;
-				auto result{ std::to_chars(arr.data(), arr.data() + arr.size(), in) };
-				if (result.ec == std::errc::value_too_large) CONTRACT_ASSERT(false, "Error converting to std::string: input too large");
-				return T(arr.data(), result.ptr - arr.data());
+			static inline T get(IntT in, tag_any_int) {
+				if constexpr (std::is_same_v<T, std::string>) {
+					return to_decimal_string<T>(in);
+				}
+				else {
+					//AnsiString has no writable buffer until it is constructed, so go via the stack. Still only the one allocation.
+					std::array<char, std::numeric_limits<IntT>::digits10 + 2> arr;
+					const auto length{ decimal_length(in) };
+					write_decimal(arr.data(), length, in);
+					return T(arr.data(), static_cast<int>(length));
+				}
 			}
 			//FLOATING POINT TYPES
 			template<typename FloatT>
 			CHARCONV_CONSTEXPR static inline T get(FloatT in, tag_floating_point) {
 				//Premake our buffer
-				std::array<char, std::numeric_limits<FloatT>::max_digits10 + 5> arr;
+				std::array<char, float_buffer_size<FloatT>> arr;
 				auto result{ std::to_chars(arr.data(), arr.data() + arr.size(), in) };
 				if (result.ec == std::errc::value_too_large) CONTRACT_ASSERT(false, "Error converting to std::string: input too large");
 				return T(arr.data(), result.ptr - arr.data());
 			}
+			template<typename FloatT>
+			static inline T get(FloatT in, tag_floating_point, fmt::spec spec) {
+				return format_floating(in, spec, [](const char* first, const char* last) { return T(first, last - first); });
+			}
 			//BOOL
 			constexpr static inline T get(bool in, instance_of<bool>) {
 				return in ? "true" : "false";
 			}
+			//ENUMS
+			template<typename E>
+			static inline T get(E in, tag_named_enum) {
+				const auto name{ enum_name(in) };
+				return T(name.data(), name.size());
+			}
+			//WIDE STRINGS
+			static inline T get(std::wstring_view in, tag_wide_string) {
+				if constexpr (std::is_same_v<T, std::string>) {
+					bool valid{ true };
+					auto out{ utf::wide_to_utf8(in, valid) };
+					CONTRACT_ASSERT(valid, "Error converting to std::string: input is not valid UTF-16 or UTF-32");
+					return out;
+				}
+				else {
+#ifdef DP_CBUILDER11
+					//AnsiString is in the system code page rather than UTF-8, which the VCL already knows how to deal with
+					return T(UnicodeString(in.data(), static_cast<int>(in.size())));
+#else
+					static_assert(dependent_false<T>, "Conversion to unsupported narrow string type");
+#endif
+				}
+			}
 		};
 
 		template<typename T>
@@ -259,22 +819,31 @@ namespace dp {
 			constexpr static inline T get(std::wstring_view in, tag_wide_string) {
 				return static_cast<T>(in);
 			}
-#ifdef DP_CBUILDER11
-			//C++Builder supports this of all things. Don't try at home
+			//NARROW STRINGS
+			//Narrow strings are taken to be UTF-8
 			static inline T get(std::string_view in, tag_narrow_string) {
+				bool valid{ true };
+				auto out{ utf::utf8_to_wide<wchar_t>(in, valid) };
+				CONTRACT_ASSERT(valid, "Error converting to wide string: input is not valid UTF-8");
 				if constexpr (std::is_same_v<T, std::wstring>) {
-					return T(in.begin(), in.end());
+					return out;
 				}
 				else {
-					return T(in.data(), in.size());
+					return T(out.data(), static_cast<int>(out.size()));
 				}
 			}
+#ifdef DP_CBUILDER11
+			//Except AnsiString, which is in the system code page. The VCL already knows how to deal with that.
+			static inline T get(const AnsiString& in, instance_of<AnsiString>) {
+				const UnicodeString wide{ in };
+				return T(wide.c_str(), static_cast<std::size_t>(wide.Length()));
+			}
 #endif
 			//INT TYPES
 			template<typename IntT>
 			static inline T get(IntT in, tag_any_int) {
 				if constexpr (std::is_same_v <T, std::wstring>) {
-					return std::to_wstring(in);
+					return to_decimal_string<T>(in);
 				}
 				else {
 #ifdef DP_CBUILDER11
@@ -294,7 +863,8 @@ namespace dp {
 			template<typename FloatT>
 			static inline T get(FloatT in, tag_floating_point) {
 				if constexpr (std::is_same_v<T, std::wstring>) {
-					return std::to_wstring(in);
+					//Unlike std::to_wstring, this gives the shortest form which round-trips rather than printf's %f
+					return to_wide_string<T, float_buffer_size<FloatT>>(in);
 				}
 				else {
 #ifdef DP_CBUILDER11
@@ -304,12 +874,43 @@ namespace dp {
 #endif
 				}
 			}
+			//With a format spec, UnicodeString goes the same way as std::wstring rather than through the VCL's formatting settings
+			template<typename FloatT>
+			static inline T get(FloatT in, tag_floating_point, fmt::spec spec) {
+				return format_floating(in, spec, [](const char* first, const char* last) {
+					if constexpr (std::is_same_v<T, std::wstring>) {
+						T out(static_cast<std::size_t>(last - first), wchar_t{});
+						widen(first, last, out.data());
+						return out;
+					}
+					else {
+						std::wstring out(static_cast<std::size_t>(last - first), wchar_t{});
+						widen(first, last, out.data());
+						return T(out.data(), static_cast<int>(out.size()));
+					}
+				});
+			}
 
 			//BOOL
 			constexpr static inline T get(bool in, instance_of<bool>) {
 				return in ? L"true" : L"false";
 			}
 
+			//ENUMS
+			//Names are taken to be ASCII, so widening is a straight copy
+			template<typename E>
+			static inline T get(E in, tag_named_enum) {
+				const auto name{ enum_name(in) };
+				std::wstring out(name.size(), wchar_t{});
+				widen(name.data(), name.data() + name.size(), out.data());
+				if constexpr (std::is_same_v<T, std::wstring>) {
+					return out;
+				}
+				else {
+					return T(out.data(), static_cast<int>(out.size()));
+				}
+			}
+
 		};
 
 
@@ -346,6 +947,50 @@ namespace dp {
 		};
 #endif
 
+		//ENUMS WITH NAMES
+		template<typename T>
+		struct conv_helper<T, std::enable_if_t<has_enum_names<T>>> {
+			//Same type
+			constexpr static inline T get(T in, instance_of<T>) {
+				return in;
+			}
+			//STRINGS
+			//A failed match reports position 0, as no prefix of the input is meaningful on its own
+			template<typename CharT>
+			constexpr static inline conversion_result<T> find(std::basic_string_view<CharT> in) {
+				const auto found{ enum_lookup<T>::find(in.data(), in.data() + in.size()) };
+				if (found == nullptr) return { conversion_error::invalid_input, 0 };
+				return { found->value, in.size() };
+			}
+			constexpr static inline conversion_result<T> try_get(std::string_view in, tag_narrow_string) {
+				return find(in);
+			}
+			static inline T get(std::string_view in, tag_narrow_string) {
+				const auto result{ find(in) };
+				CONTRACT_ASSERT(result.has_value(), enum_error_message());
+				return *result;
+			}
+			//WIDESTRINGS
+			constexpr static inline conversion_result<T> try_get(std::wstring_view in, tag_wide_string) {
+				return find(in);
+			}
+			static inline T get(std::wstring_view in, tag_wide_string) {
+				const auto result{ find(in) };
+				CONTRACT_ASSERT(result.has_value(), enum_error_message());
+				return *result;
+			}
+		};
+
+		//STD::STRING_VIEW
+		//Only enum names can be viewed without an owning string behind them
+		template<typename T>
+		struct conv_helper<T, std::enable_if_t<std::is_same_v<T, std::string_view>>> {
+			template<typename E>
+			static inline T get(E in, tag_named_enum) {
+				return enum_name(in);
+			}
+		};
+
 
 
 	}
@@ -374,8 +1019,552 @@ namespace dp {
 		return conv_impl::conv_helper<To>::get(in, instance_of<From>{});
 	}
 
+
+	//Reading integers in a particular radix
+	template<typename To>
+	To convert_to(const char* in, radix base) {
+		return conv_impl::conv_helper<To>::get(std::string_view{ in }, instance_of<std::string_view>{}, base);
+	}
+
+	template<typename To>
+	To convert_to(const wchar_t* in, radix base) {
+		return conv_impl::conv_helper<To>::get(std::wstring_view{ in }, instance_of<std::wstring_view>{}, base);
+	}
+
+	template<typename To, typename From>
+	To convert_to(const From& in, radix base) {
+		static_assert(std::is_integral_v<To>, "A radix can only be specified when converting to an integral type");
+		return conv_impl::conv_helper<To>::get(in, instance_of<From>{}, base);
+	}
+
+
+	//Writing floating point values in a particular format
+	template<typename To, typename From>
+	To convert_to(const From& in, fmt::spec spec) {
+		static_assert(std::is_floating_point_v<From>, "A format can only be specified when converting from a floating point type");
+		static_assert(conv_impl::is_owning_narrow_string<To> || conv_impl::is_owning_wide_string<To>, "A format can only be specified when converting to a string type");
+		return conv_impl::conv_helper<To>::get(in, instance_of<From>{}, spec);
+	}
+
+
+	//The non-throwing forms. Only conversions which can fail (i.e. from strings) are supported.
+	template<typename To>
+	constexpr conversion_result<To> try_convert_to(const char* in) {
+		return conv_impl::conv_helper<To>::try_get(std::string_view{ in }, instance_of<std::string_view>{});
+	}
+
+	template<typename To>
+	constexpr conversion_result<To> try_convert_to(const wchar_t* in) {
+		return conv_impl::conv_helper<To>::try_get(std::wstring_view{ in }, instance_of<std::wstring_view>{});
+	}
+
+	template<typename To, typename From>
+	constexpr conversion_result<To> try_convert_to(const From& in) {
+		return conv_impl::conv_helper<To>::try_get(in, instance_of<From>{});
+	}
+
+	template<typename To>
+	conversion_result<To> try_convert_to(const char* in, radix base) {
+		return conv_impl::conv_helper<To>::try_get(std::string_view{ in }, instance_of<std::string_view>{}, base);
+	}
+
+	template<typename To>
+	conversion_result<To> try_convert_to(const wchar_t* in, radix base) {
+		return conv_impl::conv_helper<To>::try_get(std::wstring_view{ in }, instance_of<std::wstring_view>{}, base);
+	}
+
+	template<typename To, typename From>
+	conversion_result<To> try_convert_to(const From& in, radix base) {
+		static_assert(std::is_integral_v<To>, "A radix can only be specified when converting to an integral type");
+		return conv_impl::conv_helper<To>::try_get(in, instance_of<From>{}, base);
+	}
+
+
+
+	namespace conv_impl {
+
+		template<typename T, typename CharT>
+		constexpr T parse_literal(const CharT* first, const CharT* last) {
+			//The function form of the assertion rather than the macro, as the macro fetches the handler eagerly which is never a constant expression
+			T out{};
+			if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+				//Same prefix rules as at runtime; the sign comes before the prefix so we read the magnitude separately
+				const CharT* digits{ first };
+				bool negative{ false };
+				if constexpr (std::is_signed_v<T>) {
+					negative = digits != last && *digits == CharT('-');
+					if (negative) ++digits;
+				}
+				const unsigned base{ strip_radix_prefix(digits, last, radix::detect) };
+				std::uint64_t magnitude{};
+				const auto result{ parse_integer_chars(digits, last, magnitude, static_cast<int>(base)) };
+				using unsigned_t = std::make_unsigned_t<T>;
+				const std::uint64_t limit{ std::is_signed_v<T> ? static_cast<std::uint64_t>((std::numeric_limits<T>::max)()) + (negative ? 1 : 0) : (std::numeric_limits<unsigned_t>::max)() };
+				dp::contract_assert(result.ec != std::errc::result_out_of_range && magnitude <= limit, "Error in convert_literal: literal is out of range for integer type");
+				dp::contract_assert(result.ec == std::errc{} && result.ptr == last, "Error in convert_literal: literal is not a valid integer");
+				out = negative ? static_cast<T>(-static_cast<long long>(magnitude - 1) - 1) : static_cast<T>(magnitude);
+			}
+			else if constexpr (std::is_floating_point_v<T>) {
+				static_assert(std::is_same_v<T, float> || std::numeric_limits<T>::digits == 53, "convert_literal does not support extended precision floating point types");
+				const auto result{ parse_floating_constexpr(first, last, out) };
+				dp::contract_assert(result.ec != std::errc::not_supported, "Error in convert_literal: too many significant digits to round at compile time");
+				dp::contract_assert(result.ec != std::errc::result_out_of_range, "Error in convert_literal: literal is out of range for floating point type");
+				dp::contract_assert(result.ec == std::errc{} && result.ptr == last, "Error in convert_literal: literal is not a valid floating point number");
+			}
+			else {
+				static_assert(dependent_false<T>, "convert_literal only supports integral and floating point types");
+			}
+			return out;
+		}
+
+		//Formatting into a caller-supplied range, in the style of to_chars
+		template<typename IntT>
+		inline std::to_chars_result format_chars(char* first, char* last, IntT in, tag_any_int) {
+			return format_decimal(first, last, in);
+		}
+
+		template<typename FloatT>
+		inline std::to_chars_result format_chars(char* first, char* last, FloatT in, tag_floating_point) {
+			return std::to_chars(first, last, in);
+		}
+
+		inline std::to_chars_result format_chars(char* first, char* last, bool in, instance_of<bool>) {
+			const std::string_view text{ in ? "true" : "false" };
+			if (static_cast<std::size_t>(last - first) < text.size()) return { last, std::errc::value_too_large };
+			std::char_traits<char>::copy(first, text.data(), text.size());
+			return { first + text.size(), std::errc{} };
+		}
+
+		//The most characters format_chars can produce for a given type
+		template<typename T>
+		static constexpr inline std::size_t max_format_chars = std::is_same_v<T, bool> ? 5
+			: std::is_integral_v<T> ? std::numeric_limits<T>::digits10 + 2
+			: float_buffer_size<T>;
+
+	}
+
+	/*
+	*  Compile-time conversion of literals. Unlike convert_to these don't rely on from_chars, so they can always be constant evaluated.
+	*  Where consteval is available they must be; otherwise assign the result to a constexpr variable to guarantee it.
+	*  Either way, a malformed literal (including one with trailing characters) is a compile error rather than a runtime one.
+	*/
+	template<typename To, std::size_t N>
+	DP_CONSTEVAL To convert_literal(const char(&in)[N]) {
+		return conv_impl::parse_literal<To>(in, in + N - 1);
+	}
+
+	template<typename To, std::size_t N>
+	DP_CONSTEVAL To convert_literal(const wchar_t(&in)[N]) {
+		return conv_impl::parse_literal<To>(in, in + N - 1);
+	}
+
+	/*
+	*  Serialisation into caller-owned storage. Unlike convert_to<std::string> these don't allocate a fresh string for every value,
+	*  so a loop building a large report can reuse a single buffer. All return the number of characters written.
+	*/
+	template<typename From>
+	std::size_t convert_into(char* first, char* last, const From& in) {
+		const auto result{ conv_impl::format_chars(first, last, in, instance_of<From>{}) };
+		CONTRACT_ASSERT(result.ec == std::errc{}, "Error in convert_into: output buffer too small");
+		return result.ec == std::errc{} ? static_cast<std::size_t>(result.ptr - first) : 0;
+	}
+
+	template<typename From, std::size_t N>
+	std::size_t convert_into(std::array<char, N>& out, const From& in) {
+		return convert_into(out.data(), out.data() + N, in);
+	}
+
+	template<typename From, std::size_t N>
+	std::size_t convert_into(char(&out)[N], const From& in) {
+		return convert_into(out, out + N, in);
+	}
+
+	template<typename From>
+	std::size_t convert_into(char* first, char* last, const From& in, fmt::spec spec) {
+		static_assert(std::is_floating_point_v<From>, "A format can only be specified when converting from a floating point type");
+		CONTRACT_ASSERT(spec.precision >= 0, "Error in convert_into: precision cannot be negative");
+		const auto result{ std::to_chars(first, last, in, spec.format, spec.precision) };
+		CONTRACT_ASSERT(result.ec == std::errc{}, "Error in convert_into: output buffer too small");
+		return result.ec == std::errc{} ? static_cast<std::size_t>(result.ptr - first) : 0;
+	}
+
+	template<typename From>
+	std::size_t append_to(std::string& out, const From& in) {
+		std::array<char, conv_impl::max_format_chars<From>> buffer;
+		const auto written{ convert_into(buffer, in) };
+		out.append(buffer.data(), written);
+		return written;
+	}
+
+	template<typename From>
+	std::size_t append_to(std::wstring& out, const From& in) {
+		std::array<char, conv_impl::max_format_chars<From>> buffer;
+		const auto written{ convert_into(buffer, in) };
+		const auto old_size{ out.size() };
+		out.resize(old_size + written);
+		conv_impl::widen(buffer.data(), buffer.data() + written, out.data() + old_size);
+		return written;
+	}
+
+	template<typename From>
+	std::size_t append_to(std::string& out, const From& in, fmt::spec spec) {
+		static_assert(std::is_floating_point_v<From>, "A format can only be specified when converting from a floating point type");
+		return conv_impl::format_floating(in, spec, [&](const char* first, const char* last) {
+			out.append(first, last);
+			return static_cast<std::size_t>(last - first);
+		});
+	}
+
+	template<typename From>
+	std::size_t append_to(std::wstring& out, const From& in, fmt::spec spec) {
+		static_assert(std::is_floating_point_v<From>, "A format can only be specified when converting from a floating point type");
+		return conv_impl::format_floating(in, spec, [&](const char* first, const char* last) {
+			const auto old_size{ out.size() };
+			out.resize(old_size + static_cast<std::size_t>(last - first));
+			conv_impl::widen(first, last, out.data() + old_size);
+			return static_cast<std::size_t>(last - first);
+		});
+	}
+
+	//Replaces the contents of the string, but keeps its storage
+	template<typename From>
+	std::size_t convert_into(std::string& out, const From& in) {
+		out.clear();
+		return append_to(out, in);
+	}
+
+	template<typename From>
+	std::size_t convert_into(std::wstring& out, const From& in) {
+		out.clear();
+		return append_to(out, in);
+	}
+
+	template<typename From>
+	std::size_t convert_into(std::string& out, const From& in, fmt::spec spec) {
+		out.clear();
+		return append_to(out, in, spec);
+	}
+
+	template<typename From>
+	std::size_t convert_into(std::wstring& out, const From& in, fmt::spec spec) {
+		out.clear();
+		return append_to(out, in, spec);
+	}
+
+
+	/*
+	*  Bulk conversion. When converting a whole column of data, a failure in one element is rarely a reason to abandon the rest
+	*  so rather than going through the contract machinery once per element, failures are recorded one bit per element in an error_bitmap.
+	*  The bitmap can be reused between calls, in which case it will not reallocate unless the input grows.
+	*/
+	class error_bitmap {
+		std::vector<std::uint64_t> bits;
+		std::size_t length{ 0 };
+
+		static constexpr std::size_t word_bits{ 64 };
+
+	public:
+		error_bitmap() = default;
+		explicit error_bitmap(std::size_t size) {
+			reset(size);
+		}
+
+		//Clear all errors and resize to hold the given number of elements
+		void reset(std::size_t size) {
+			length = size;
+			bits.assign((size + word_bits - 1) / word_bits, 0);
+		}
+
+		//Resize without clearing, any newly added elements are marked as successful
+		void resize(std::size_t size) {
+			length = size;
+			bits.resize((size + word_bits - 1) / word_bits, 0);
+			if (size % word_bits != 0) bits.back() &= (std::uint64_t{ 1 } << (size % word_bits)) - 1;
+		}
+
+		void set(std::size_t index) {
+			bits[index / word_bits] |= std::uint64_t{ 1 } << (index % word_bits);
+		}
+
+		bool test(std::size_t index) const {
+			return (bits[index / word_bits] >> (index % word_bits)) & 1;
+		}
+
+		bool any() const {
+			for (auto word : bits) {
+				if (word != 0) return true;
+			}
+			return false;
+		}
+
+		std::size_t count() const {
+			std::size_t total{ 0 };
+			for (auto word : bits) {
+				for (; word != 0; word &= word - 1) ++total;
+			}
+			return total;
+		}
+
+		//Index of the first failed element, or size() if there were no failures
+		std::size_t first() const {
+			for (std::size_t i = 0; i < bits.size(); ++i) {
+				if (bits[i] == 0) continue;
+				std::size_t index{ i * word_bits };
+				for (auto word = bits[i]; (word & 1) == 0; word >>= 1) ++index;
+				return index;
+			}
+			return length;
+		}
+
+		std::size_t size() const {
+			return length;
+		}
+
+		const std::uint64_t* data() const {
+			return bits.data();
+		}
+	};
+
+
+	namespace conv_impl {
+
+		//Converts elements [begin, end) and returns the number of successes
+		template<typename To, typename InPtr>
+		std::size_t convert_block(InPtr in_ptr, To* out_ptr, std::size_t begin, std::size_t end, error_bitmap& errors) {
+			std::size_t converted{ 0 };
+			for (std::size_t i = begin; i < end; ++i) {
+				//A failed conversion holds a value-initialized To
+				const auto result{ conv_helper<To>::try_get(std::string_view{ in_ptr[i] }, tag_narrow_string{}) };
+				if (result.has_value()) {
+					++converted;
+				}
+				else {
+					errors.set(i);
+				}
+				out_ptr[i] = *result;
+			}
+			return converted;
+		}
+
+	}
+
+	//Converts every string in the input range into the corresponding element of the output range.
+	//Failed elements are value-initialized in the output and flagged in the bitmap. Returns the number of successful conversions.
+	template<typename To, typename InRange, typename OutRange>
+	std::size_t convert_range(const InRange& in, OutRange& out, error_bitmap& errors) {
+		const std::size_t count{ std::size(in) };
+		CONTRACT_ASSERT(std::size(out) >= count, "Error in convert_range: output range is smaller than input range");
+		errors.reset(count);
+		return conv_impl::convert_block<To>(std::data(in), std::data(out), 0, count, errors);
+	}
+
+
+	/*
+	*  Parallel bulk conversion. The input is cut into chunks which worker threads take in turn, so an uneven mix of short and long strings
+	*  still balances out. Chunks are a multiple of 64 elements so no two threads ever write to the same word of the error bitmap,
+	*  which means the bitmap (and so errors.first()) comes out exactly as it would from the sequential version.
+	*
+	*  We use our own threads rather than std::execution::par_unseq, as not every standard library we target has the parallel algorithms
+	*  and the ones that do may quietly need an extra runtime library to be linked.
+	*/
+	struct parallel_policy {
+		//Zero means use std::thread::hardware_concurrency()
+		unsigned int threads{ 0 };
+		//Number of elements handed to a worker at a time; rounded up to a multiple of 64
+		std::size_t chunk_size{ 4096 };
+	};
+	inline constexpr parallel_policy parallel{};
+
+	template<typename To, typename InRange, typename OutRange>
+	std::size_t convert_range(parallel_policy policy, const InRange& in, OutRange& out, error_bitmap& errors) {
+		const std::size_t count{ std::size(in) };
+		CONTRACT_ASSERT(std::size(out) >= count, "Error in convert_range: output range is smaller than input range");
+		errors.reset(count);
+
+		const auto in_ptr{ std::data(in) };
+		To* const out_ptr{ std::data(out) };
+
+		const std::size_t chunk_size{ ((std::max<std::size_t>)(policy.chunk_size, 1) + 63) / 64 * 64 };
+		const std::size_t chunks{ (count + chunk_size - 1) / chunk_size };
+		std::size_t threads{ policy.threads != 0 ? policy.threads : std::thread::hardware_concurrency() };
+		threads = (std::min<std::size_t>)((std::max<std::size_t>)(threads, 1), chunks);
+		if (threads <= 1) return conv_impl::convert_block<To>(in_ptr, out_ptr, 0, count, errors);
+
+		std::atomic<std::size_t> next_chunk{ 0 };
+		std::atomic<std::size_t> converted{ 0 };
+		const auto worker{ [&]() {
+			std::size_t local{ 0 };
+			for (auto chunk = next_chunk.fetch_add(1, std::memory_order_relaxed); chunk < chunks; chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) {
+				const std::size_t begin{ chunk * chunk_size };
+				local += conv_impl::convert_block<To>(in_ptr, out_ptr, begin, (std::min)(begin + chunk_size, count), errors);
+			}
+			converted.fetch_add(local, std::memory_order_relaxed);
+		} };
+
+		//The calling thread does its share of the work too
+		std::vector<std::thread> pool;
+		pool.reserve(threads - 1);
+		for (std::size_t i = 1; i < threads; ++i) pool.emplace_back(worker);
+		worker();
+		for (auto& thread : pool) thread.join();
+		return converted.load();
+	}
+
+	//Converts each delimited field of the buffer into consecutive elements of the output range.
+	//As with the overloads above, returns the number of successful conversions; the number of fields written is errors.size().
+	//An empty buffer holds no fields, and a delimiter at the very end terminates the last field rather than starting an empty one.
+	//Parsing stops once the output range is full.
+	template<typename To, typename OutRange>
+	std::size_t convert_range(std::string_view buffer, char delimiter, OutRange& out, error_bitmap& errors) {
+		const std::size_t capacity{ std::size(out) };
+		To* out_ptr{ std::data(out) };
+		errors.reset(capacity);
+
+		std::size_t fields{ 0 };
+		std::size_t converted{ 0 };
+		while (!buffer.empty() && fields < capacity) {
+			const auto split{ buffer.find(delimiter) };
+			const auto result{ conv_impl::conv_helper<To>::try_get(buffer.substr(0, split), tag_narrow_string{}) };
+			if (result.has_value()) ++converted;
+			else errors.set(fields);
+			out_ptr[fields++] = *result;
+
+			if (split == std::string_view::npos) break;
+			buffer.remove_prefix(split + 1);
+		}
+		errors.resize(fields);
+		return converted;
+	}
+
+
+
+
+	/*
+	*  Single-pass parsing of delimited text. Each record is split and its fields converted straight into a std::tuple<Ts...>,
+	*  so there is no separate splitting pass over memory. Delimiters are found with string_view::find, which ends up in memchr.
+	*  std::string_view fields are zero-copy views into the buffer; every other type goes through the same cores as try_convert_to.
+	*
+	*  To process input of any size in bounded memory, feed it in chunks. parse() handles every complete record in the chunk and
+	*  returns how many characters it consumed; the remainder is the start of an incomplete record, which should be moved to the front
+	*  of the buffer before reading the next chunk. Once the input is exhausted, pass whatever remains to finish().
+	*/
+	namespace conv_impl {
+
+		template<typename T>
+		inline bool parse_field(std::string_view field, T& out) {
+			if constexpr (std::is_same_v<T, std::string_view>) {
+				out = field;
+				return true;
+			}
+			else if constexpr (std::is_same_v<T, std::string>) {
+				out.assign(field.data(), field.size());
+				return true;
+			}
+			else {
+				const auto result{ conv_helper<T>::try_get(field, tag_narrow_string{}) };
+				out = *result;
+				return result.has_value();
+			}
+		}
+
+	}
+
+	template<typename... Ts>
+	class field_parser {
+	public:
+		using record_type = std::tuple<Ts...>;
+		//One bit per field which failed to convert or was missing from the record
+		using error_type = std::bitset<sizeof...(Ts)>;
+
+	private:
+		char delimiter;
+		char terminator;
+
+		template<std::size_t I>
+		void parse_one(std::string_view& remaining, bool& exhausted, record_type& out, error_type& errors) const {
+			using field_type = std::tuple_element_t<I, record_type>;
+			if (exhausted) {
+				std::get<I>(out) = field_type{};
+				errors.set(I);
+				return;
+			}
+			const auto split{ remaining.find(delimiter) };
+			if (!conv_impl::parse_field(remaining.substr(0, split), std::get<I>(out))) errors.set(I);
+			if (split == std::string_view::npos) {
+				exhausted = true;
+			}
+			else {
+				remaining.remove_prefix(split + 1);
+			}
+		}
+
+		template<std::size_t... Is>
+		error_type parse_record_impl(std::string_view line, record_type& out, std::index_sequence<Is...>) const {
+			error_type errors{};
+			bool exhausted{ false };
+			(parse_one<Is>(line, exhausted, out, errors), ...);
+			return errors;
+		}
+
+	public:
+		constexpr explicit field_parser(char in_delimiter = ',', char in_terminator = '\n') : delimiter{ in_delimiter }, terminator{ in_terminator } {}
+
+		//Parse a single record, which should not include its terminator. Fields past the end of the tuple are ignored.
+		error_type parse_record(std::string_view line, record_type& out) const {
+			//Tolerate Windows line endings
+			if (terminator == '\n' && !line.empty() && line.back() == '\r') line.remove_suffix(1);
+			return parse_record_impl(line, out, std::index_sequence_for<Ts...>{});
+		}
+
+		//Calls on_record(record_type&, const error_type&) for every complete record in the chunk. Returns the number of characters consumed.
+		//The record passed to the callback is reused between calls, so move from it if you want to keep it.
+		template<typename Callback>
+		std::size_t parse(std::string_view chunk, Callback&& on_record) const {
+			record_type record{};
+			std::size_t consumed{ 0 };
+			for (auto end = chunk.find(terminator); end != std::string_view::npos; end = chunk.find(terminator, consumed)) {
+				const auto errors{ parse_record(chunk.substr(consumed, end - consumed), record) };
+				on_record(record, errors);
+				consumed = end + 1;
+			}
+			return consumed;
+		}
+
+		//Handle the final record of the input, which need not have a terminator
+		template<typename Callback>
+		void finish(std::string_view tail, Callback&& on_record) const {
+			if (tail.empty()) return;
+			record_type record{};
+			const auto errors{ parse_record(tail, record) };
+			on_record(record, errors);
+		}
+	};
+
+	//Convenience for a buffer which holds the whole input. Records with any failed field are flagged in failed_records.
+	template<typename... Ts>
+	std::vector<std::tuple<Ts...>> parse_fields(std::string_view buffer, char delimiter, error_bitmap& failed_records) {
+		const field_parser<Ts...> parser{ delimiter };
+		std::vector<std::tuple<Ts...>> records;
+		failed_records.reset(0);
+		const auto on_record{ [&](auto& record, const auto& errors) {
+			failed_records.resize(records.size() + 1);
+			if (errors.any()) failed_records.set(records.size());
+			records.push_back(std::move(record));
+		} };
+		const auto consumed{ parser.parse(buffer, on_record) };
+		parser.finish(buffer.substr(consumed), on_record);
+		return records;
+	}
+
+	template<typename... Ts>
+	std::vector<std::tuple<Ts...>> parse_fields(std::string_view buffer, char delimiter = ',') {
+		error_bitmap ignored;
+		return parse_fields<Ts...>(buffer, delimiter, ignored);
+	}
+
 }
 
 #undef CHARCONV_CONSTEXPR
+#undef DP_CONSTEVAL
 
 #endif
\ No newline at end of file
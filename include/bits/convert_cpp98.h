@@ -8,11 +8,13 @@
 #include <string>
 #include <cstdlib>
 #include <climits>
+#include <cmath>
 #include <sstream>
 
 
 #include "tmp_tags.h"
 #include "support_tools.h"
+#include "charconv_cpp98.h"
 #include "contracts.h"
 
 /*
@@ -56,20 +58,20 @@ namespace dp {
 			//C-STRING
 			//Can't be DRY with std::string :(
 			template<std::size_t N>
-			static inline T get(const char(&in)[N], instance_of<char[N]>) {
-				char* end = NULL;
-				long result = std::strtol(in, &end, 0);
+			static inline T get(const char(&in)[N], instance_of<char[N]>, radix::type base = radix::detect) {
+				T result = 0;
+				const bool success = parse_integer(in, in + std::char_traits<char>::length(in), base, result);
 
-				CONTRACT_ASSERT(result != LONG_MAX && result != LONG_MIN, "Error converting a C-string to integer type via convert_to");
-				return static_cast<T>(result);
+				CONTRACT_ASSERT(success, "Error converting a C-string to integer type via convert_to");
+				return result;
 			}
 			//STD::STRING
-			static inline T get(const std::string& in, instance_of<std::string>) {
-				char* end = NULL;
-				long result = std::strtol(in.c_str(), &end, 0);
+			static inline T get(const std::string& in, instance_of<std::string>, radix::type base = radix::detect) {
+				T result = 0;
+				const bool success = parse_integer(in.data(), in.data() + in.size(), base, result);
 
-				CONTRACT_ASSERT(result != LONG_MAX && result != LONG_MIN, "Error converting a std::string to integer type via convert_to");
-				return static_cast<T>(result);
+				CONTRACT_ASSERT(success, "Error converting a std::string to integer type via convert_to");
+				return result;
 			}
 		};
 
@@ -93,20 +95,20 @@ namespace dp {
 			}
 			//C-String
 			template<std::size_t N>
-			static inline T get(const char(&in)[N], instance_of<char[N]>) {
-				char* end = NULL;
-				unsigned long result = std::strtoul(in, &end, 0);
+			static inline T get(const char(&in)[N], instance_of<char[N]>, radix::type base = radix::detect) {
+				T result = 0;
+				const bool success = parse_integer(in, in + std::char_traits<char>::length(in), base, result);
 
-				CONTRACT_ASSERT(result != ULONG_MAX, "Error converting a C-string to integer type via convert_to");
-				return static_cast<T>(result);
+				CONTRACT_ASSERT(success, "Error converting a C-string to integer type via convert_to");
+				return result;
 			}
 			//STD::STRING
-			static inline T get(const std::string& in, instance_of<std::string>) {
-				char* end = NULL;
-				unsigned long result = std::strtoul(in.c_str(), &end, 0);
+			static inline T get(const std::string& in, instance_of<std::string>, radix::type base = radix::detect) {
+				T result = 0;
+				const bool success = parse_integer(in.data(), in.data() + in.size(), base, result);
 
-				CONTRACT_ASSERT(result != ULONG_MAX, "Error converting a std::string to integer type via convert_to");
-				return static_cast<T>(result);
+				CONTRACT_ASSERT(success, "Error converting a std::string to integer type via convert_to");
+				return result;
 			}
 		};
 
@@ -161,19 +163,14 @@ namespace dp {
 		template<typename T>
 		struct conv_helper<T, typename dp::support::enable_if<dp::support::is_same<std::string, T>::value>::type> {
 			//INT
-			//Suboptimal that tag dispatch means we have two identicl function bodies, but needs must
 			template<typename IntT>
 			static inline T get(IntT in, tag_any_int) {
-				std::stringstream ss;
-				ss << in;
-				return ss.str();
+				return format_integer_string<T>(in);
 			}
 			//FLOAT
 			template<typename FloatT>
 			static inline T get(FloatT in, tag_floating_point) {
-				std::stringstream ss;
-				ss << in;
-				return ss.str();
+				return format_floating_string<T>(in);
 			}
 			//BOOL
 			static inline T get(bool in, instance_of<bool>) {
@@ -196,16 +193,12 @@ namespace dp {
 			//INT
 			template<typename IntT>
 			static inline T get(IntT in, tag_any_int) {
-				std::wstringstream ss;
-				ss << in;
-				return ss.str();
+				return format_integer_string<T>(in);
 			}
 			//FLOAT
 			template<typename FloatT>
 			static inline T get(FloatT in, tag_floating_point) {
-				std::wstringstream ss;
-				ss << in;
-				return ss.str();
+				return format_floating_string<T>(in);
 			}
 			//BOOL
 			static inline T get(bool in, instance_of<bool>) {
@@ -232,6 +225,12 @@ namespace dp {
 		return conv_impl::conv_helper<To>::get(in, instance_of<From>());
 	}
 
+	//Reading integers in a particular radix
+	template<typename To, typename From>
+	To convert_to(const From& in, radix::type base) {
+		return conv_impl::conv_helper<To>::get(in, instance_of<From>(), base);
+	}
+
 
 }
 
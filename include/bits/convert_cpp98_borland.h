@@ -17,6 +17,7 @@
 #include "bits/support_tools.h"
 #include "bits/borland_version_defs.h"
 #include "bits/tmp_tags.h"
+#include "bits/charconv_cpp98.h"
 
 /*
 *	The template engine on the Borland C++Builder compiler is weak and noncompliant.
@@ -33,6 +34,8 @@ namespace dp {
 	//Forward dec
 	template<typename To, typename From>
 	To convert_to(const From&);
+	template<typename To, typename From>
+	To convert_to(const From&, radix::type);
 
 
 
@@ -71,9 +74,7 @@ namespace dp {
 		//INT TO STD::STRING
 		template<typename To, typename From>
 		typename dp::support::enable_if<dp::support::is_same<To, std::string>::value, To>::type fun(From in, tag_any_int) {
-			std::stringstream ss;
-			ss << in;
-			return ss.str();
+			return format_integer_string<To>(in);
 		}
 
 		//SIGNED INT TO DELPHI STRING
@@ -118,9 +119,7 @@ namespace dp {
 		//FLOAT TO STD::STRING
 		template<typename To, typename From>
 		typename dp::support::enable_if<dp::support::is_same<To, std::string>::value, To>::type fun(From in, tag_floating_point) {
-			std::stringstream ss;
-			ss << in;
-			return ss.str();
+			return format_floating_string<To>(in);
 		}
 
 		//FLOAT TO DELPHI STRING
@@ -151,22 +150,18 @@ namespace dp {
 
 		//STD::STRING TO SIGNED INT
 		template<typename To, typename From>
-		typename dp::support::enable_if<dp::support::is_integral<To>::value&& dp::support::is_signed<To>::value, To>::type fun(const From& in, instance_of<std::string>) {
-			char* end = NULL;
-			long result = std::strtol(in.c_str(), &end, 0);
-
-			if (result == LONG_MAX || result == LONG_MIN) throw Exception("Error converting a std::string to integer type via convert_to");
-			return static_cast<To>(result);
+		typename dp::support::enable_if<dp::support::is_integral<To>::value&& dp::support::is_signed<To>::value, To>::type fun(const From& in, instance_of<std::string>, radix::type base = radix::detect) {
+			To result = 0;
+			if (!parse_integer(in.data(), in.data() + in.size(), base, result)) throw Exception("Error converting a std::string to integer type via convert_to");
+			return result;
 		}
 
 		//STD::STRING TO UNSIGNED INT
 		template<typename To, typename From>
-		typename dp::support::enable_if<dp::support::is_integral<To>::value && !dp::support::is_signed<To>::value, To>::type fun(const From& in, instance_of<std::string>) {
-			char* end = NULL;
-			unsigned long result = std::strtoul(in.c_str(), &end, 0);
-
-			if (result == ULONG_MAX) throw Exception("Error converting a std::string to integer type via convert_to");
-			return static_cast<To>(result);
+		typename dp::support::enable_if<dp::support::is_integral<To>::value && !dp::support::is_signed<To>::value, To>::type fun(const From& in, instance_of<std::string>, radix::type base = radix::detect) {
+			To result = 0;
+			if (!parse_integer(in.data(), in.data() + in.size(), base, result)) throw Exception("Error converting a std::string to integer type via convert_to");
+			return result;
 		}
 
 		//STD::STRING TO FLOAT
@@ -197,16 +192,35 @@ namespace dp {
 			return Currency(convert_to<double>(in));
 		}
 
+		//DELPHI STRING TO INT
+		//StrToInt and friends only know about $ and 0x, so we read the characters in place with the same rules as std::string.
+		//Length() rather than the null terminator marks the end, and a UnicodeString is read as wide characters rather than narrowed first.
+		//Failure throws EConvertError, as StrToInt does.
+		template<typename To, typename From>
+		To parse_delphi_integer(const From& in, radix::type base) {
+			To result = 0;
+			if (!parse_integer(in.c_str(), in.c_str() + in.Length(), base, result)) throw EConvertError("Error converting a Delphi string to integer type via convert_to");
+			return result;
+		}
+
 		//DELPHI STRING TO SIGNED INT
 		template<typename To, typename From>
 		typename dp::support::enable_if<dp::support::is_integral<To>::value&& dp::support::is_signed<To>::value, To>::type fun(const From& in, tag_delphi_string) {
-			return static_cast<To>(StrToInt(in));
+			return parse_delphi_integer<To>(in, radix::detect);
+		}
+		template<typename To, typename From>
+		typename dp::support::enable_if<dp::support::is_integral<To>::value&& dp::support::is_signed<To>::value, To>::type fun(const From& in, tag_delphi_string, radix::type base) {
+			return parse_delphi_integer<To>(in, base);
 		}
 
 		//DELPHI STRING TO UNSIGNED INT
 		template<typename To, typename From>
 		typename dp::support::enable_if<dp::support::is_integral<To>::value && !dp::support::is_signed<To>::value, To>::type fun(const From& in, tag_delphi_string) {
-			return static_cast<To>(StrToUInt(in));
+			return parse_delphi_integer<To>(in, radix::detect);
+		}
+		template<typename To, typename From>
+		typename dp::support::enable_if<dp::support::is_integral<To>::value && !dp::support::is_signed<To>::value, To>::type fun(const From& in, tag_delphi_string, radix::type base) {
+			return parse_delphi_integer<To>(in, base);
 		}
 
 		//DELPHI STRING TO FLOAT
@@ -257,6 +271,14 @@ namespace dp {
 		To fun(const From& in, instance_of<const wchar_t*>) {
 			return convert_to<To>(std::wstring(in));
 		}
+		template<typename To, typename From>
+		To fun(const From& in, instance_of<char*>, radix::type base) {
+			return convert_to<To>(std::string(in), base);
+		}
+		template<typename To, typename From>
+		To fun(const From& in, instance_of<const char*>, radix::type base) {
+			return convert_to<To>(std::string(in), base);
+		}
 	}
 
 
@@ -266,6 +288,12 @@ namespace dp {
 		return conv_impl::fun<To, From>(in, instance_of<typename dp::support::decay_if_array<From>::type>());
 	}
 
+	//Reading integers in a particular radix
+	template<typename To, typename From>
+	To convert_to(const From& in, radix::type base) {
+		return conv_impl::fun<To, From>(in, instance_of<typename dp::support::decay_if_array<From>::type>(), base);
+	}
+
 
 
 
@@ -1,6 +1,9 @@
 #ifndef DP_CPP98_SUPPORT_TOOLS
 #define DP_CPP98_SUPPORT_TOOLS
 
+//For LLONG_MAX, which tells us whether long long exists
+#include <climits>
+
 //Rather than reinvent the type_traits wheel in every header that requires it
 //or add my cpp98 lib as a hard requirement; we provide a quick example of what we need.
 namespace dp {
@@ -63,6 +66,13 @@ namespace dp {
             is_same<typename remove_cv<T>::type, unsigned int>::value ||
             is_same<typename remove_cv<T>::type, signed long>::value ||
             is_same<typename remove_cv<T>::type, unsigned long>::value ||
+#if defined(LLONG_MAX)
+            is_same<typename remove_cv<T>::type, signed long long>::value ||
+            is_same<typename remove_cv<T>::type, unsigned long long>::value ||
+#elif defined(__BORLANDC__)
+            is_same<typename remove_cv<T>::type, __int64>::value ||
+            is_same<typename remove_cv<T>::type, unsigned __int64>::value ||
+#endif
             is_same<typename remove_cv<T>::type, wchar_t>::value> {};
 
         template<typename T>
@@ -0,0 +1,213 @@
+#ifndef DP_CPP17_UTF
+#define DP_CPP17_UTF
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/*
+*  Transcoding between UTF-8 and UTF-16 or UTF-32, for conversions between narrow and wide strings.
+*  Which of UTF-16 and UTF-32 is used depends only on the size of the wide character type, so wchar_t gets UTF-16 on Windows
+*  (and so matches UnicodeString) and UTF-32 elsewhere.
+*
+*  Most text we see is mostly ASCII, so both directions check 16 characters at a time and copy them straight across when they are.
+*  Everything else goes through a validating decoder. Invalid input is never passed through: each maximal invalid subsequence becomes
+*  U+FFFD as the Unicode standard recommends, and the caller is told so it can decide whether that is acceptable.
+*
+*  Full documentation here: https://github.com/DryPerspective/C_Builder_Extras/wiki/Convert
+*/
+
+namespace dp {
+	namespace conv_impl {
+		namespace utf {
+
+			constexpr inline char32_t replacement_character{ 0xFFFD };
+			constexpr inline std::size_t block_size{ 16 };
+
+			//True if the next block_size bytes are all ASCII
+			inline bool is_ascii_block(const char* in) {
+				std::uint64_t first;
+				std::uint64_t second;
+				std::memcpy(&first, in, sizeof(first));
+				std::memcpy(&second, in + sizeof(first), sizeof(second));
+				return ((first | second) & 0x8080808080808080ull) == 0;
+			}
+
+			//True if the next block_size code units are all ASCII. A plain loop which compilers happily vectorise.
+			template<typename CharT>
+			inline bool is_ascii_block(const CharT* in) {
+				using unsigned_t = std::make_unsigned_t<CharT>;
+				unsigned_t combined{ 0 };
+				for (std::size_t i = 0; i < block_size; ++i) {
+					combined |= static_cast<unsigned_t>(in[i]);
+				}
+				return combined < 0x80;
+			}
+
+			template<typename To, typename From>
+			inline void copy_block(const From* in, To* out) {
+				for (std::size_t i = 0; i < block_size; ++i) {
+					out[i] = static_cast<To>(in[i]);
+				}
+			}
+
+			struct decoded_code_point {
+				char32_t code_point;
+				std::size_t length;
+				bool valid;
+			};
+
+			//Decodes a single code point from a non-empty range, following the table of well-formed sequences in the Unicode standard
+			//so overlong forms, surrogates and values past U+10FFFF are all rejected.
+			inline decoded_code_point decode_utf8(const unsigned char* in, std::size_t available) {
+				const unsigned lead{ in[0] };
+				if (lead < 0x80) return { lead, 1, true };
+
+				std::size_t length{ 0 };
+				char32_t code_point{ 0 };
+				//The valid range of the second byte depends on the first
+				unsigned lower{ 0x80 };
+				unsigned upper{ 0xBF };
+				if (lead >= 0xC2 && lead <= 0xDF) {
+					length = 2;
+					code_point = lead & 0x1F;
+				}
+				else if (lead >= 0xE0 && lead <= 0xEF) {
+					length = 3;
+					code_point = lead & 0x0F;
+					if (lead == 0xE0) lower = 0xA0;
+					else if (lead == 0xED) upper = 0x9F;
+				}
+				else if (lead >= 0xF0 && lead <= 0xF4) {
+					length = 4;
+					code_point = lead & 0x07;
+					if (lead == 0xF0) lower = 0x90;
+					else if (lead == 0xF4) upper = 0x8F;
+				}
+				else {
+					return { replacement_character, 1, false };
+				}
+
+				for (std::size_t i = 1; i < length; ++i) {
+					if (i >= available || in[i] < lower || in[i] > upper) return { replacement_character, i, false };
+					code_point = (code_point << 6) | (in[i] & 0x3F);
+					lower = 0x80;
+					upper = 0xBF;
+				}
+				return { code_point, length, true };
+			}
+
+			template<typename CharT>
+			inline CharT* encode_wide(char32_t code_point, CharT* out) {
+				static_assert(sizeof(CharT) >= 2, "Wide strings must have at least 16-bit characters");
+				if constexpr (sizeof(CharT) >= 4) {
+					*out++ = static_cast<CharT>(code_point);
+				}
+				else if (code_point < 0x10000) {
+					*out++ = static_cast<CharT>(code_point);
+				}
+				else {
+					code_point -= 0x10000;
+					*out++ = static_cast<CharT>(0xD800 + (code_point >> 10));
+					*out++ = static_cast<CharT>(0xDC00 + (code_point & 0x3FF));
+				}
+				return out;
+			}
+
+			inline char* encode_utf8(char32_t code_point, char* out) {
+				if (code_point < 0x80) {
+					*out++ = static_cast<char>(code_point);
+				}
+				else if (code_point < 0x800) {
+					*out++ = static_cast<char>(0xC0 | (code_point >> 6));
+					*out++ = static_cast<char>(0x80 | (code_point & 0x3F));
+				}
+				else if (code_point < 0x10000) {
+					*out++ = static_cast<char>(0xE0 | (code_point >> 12));
+					*out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+					*out++ = static_cast<char>(0x80 | (code_point & 0x3F));
+				}
+				else {
+					*out++ = static_cast<char>(0xF0 | (code_point >> 18));
+					*out++ = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+					*out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+					*out++ = static_cast<char>(0x80 | (code_point & 0x3F));
+				}
+				return out;
+			}
+
+			//Each byte of UTF-8 becomes at most one code unit (a four byte sequence becomes a surrogate pair) so we can size the output up front
+			template<typename CharT>
+			std::basic_string<CharT> utf8_to_wide(std::string_view in, bool& valid) {
+				std::basic_string<CharT> out(in.size(), CharT{});
+				CharT* dest{ out.data() };
+				const char* ptr{ in.data() };
+				const char* const last{ ptr + in.size() };
+				valid = true;
+
+				while (ptr != last) {
+					while (static_cast<std::size_t>(last - ptr) >= block_size && is_ascii_block(ptr)) {
+						copy_block(ptr, dest);
+						ptr += block_size;
+						dest += block_size;
+					}
+					if (ptr == last) break;
+
+					const auto decoded{ decode_utf8(reinterpret_cast<const unsigned char*>(ptr), static_cast<std::size_t>(last - ptr)) };
+					valid = valid && decoded.valid;
+					dest = encode_wide(decoded.code_point, dest);
+					ptr += decoded.length;
+				}
+				out.resize(static_cast<std::size_t>(dest - out.data()));
+				return out;
+			}
+
+			//A UTF-16 code unit is at most three bytes of UTF-8 (a surrogate pair is four bytes for two units), a UTF-32 one at most four
+			template<typename CharT>
+			std::string wide_to_utf8(std::basic_string_view<CharT> in, bool& valid) {
+				static_assert(sizeof(CharT) >= 2, "Wide strings must have at least 16-bit characters");
+				using unsigned_t = std::make_unsigned_t<CharT>;
+				std::string out(in.size() * (sizeof(CharT) == 2 ? 3 : 4), '\0');
+				char* dest{ out.data() };
+				const CharT* ptr{ in.data() };
+				const CharT* const last{ ptr + in.size() };
+				valid = true;
+
+				while (ptr != last) {
+					while (static_cast<std::size_t>(last - ptr) >= block_size && is_ascii_block(ptr)) {
+						copy_block(ptr, dest);
+						ptr += block_size;
+						dest += block_size;
+					}
+					if (ptr == last) break;
+
+					char32_t code_point{ static_cast<unsigned_t>(*ptr++) };
+					if (code_point >= 0xD800 && code_point <= 0xDFFF) {
+						//Only a high surrogate followed by a low one is valid, and only in UTF-16
+						const bool paired{ sizeof(CharT) == 2 && code_point <= 0xDBFF && ptr != last
+							&& static_cast<unsigned_t>(*ptr) >= 0xDC00 && static_cast<unsigned_t>(*ptr) <= 0xDFFF };
+						if (paired) {
+							code_point = 0x10000 + ((code_point - 0xD800) << 10) + (static_cast<unsigned_t>(*ptr++) - 0xDC00);
+						}
+						else {
+							code_point = replacement_character;
+							valid = false;
+						}
+					}
+					else if (code_point > 0x10FFFF) {
+						code_point = replacement_character;
+						valid = false;
+					}
+					dest = encode_utf8(code_point, dest);
+				}
+				out.resize(static_cast<std::size_t>(dest - out.data()));
+				return out;
+			}
+
+		}
+	}
+}
+
+#endif
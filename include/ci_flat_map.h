@@ -0,0 +1,464 @@
+#ifndef DP_CI_FLAT_MAP
+#define DP_CI_FLAT_MAP
+
+/*
+*  An open-addressing hash map keyed on case-insensitive strings, for dictionaries such as HTTP headers or INI keys where
+*  std::unordered_map spends its time allocating nodes and chasing pointers.
+*
+*  The layout follows the SwissTable design. Slots live in one flat array, and alongside it each slot has a control byte holding
+*  seven bits of its key's ci_hash. A lookup checks sixteen control bytes at once, and only compares a key where the hash matches.
+*  Each slot also keeps the full hash, so a fingerprint collision rarely reaches a string compare and growing never hashes a key again.
+*  Short keys stay inline in their slot through the small string buffer of ci_string, so there is no allocation per entry for them.
+*
+*  Like the standard unordered containers, any operation which inserts may invalidate iterators and references. Unlike them, that means
+*  references to every entry, not just iterators. The new entry is built before anything moves, so m.try_emplace(key, m.at(other))
+*  and m.insert_or_assign(key, m.at(other)) are safe. m[key] = m.at(other) is not, as the reference is taken before m[key] inserts.
+*  Lookups accept any string type ci_hash does, so a std::string_view or a literal never has to become a ci_string to be found.
+*/
+
+#ifdef __BORLANDC__
+#include "bits/borland_version_defs.h"
+#endif
+
+#if !(defined(DP_CBUILDER11) || __cplusplus >= 201703L || _MSVC_LANG >= 201703L)
+#error "dp::ci_flat_map requires C++17"
+#endif
+
+#include "ci_traits.h"
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace dp {
+
+	template<typename CharT, typename T>
+	class basic_ci_flat_map {
+	public:
+		using key_type = std::basic_string<CharT, ci_traits<CharT>>;
+		using mapped_type = T;
+		using value_type = std::pair<const key_type, T>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using hasher = ci_hash;
+		using key_equal = ci_equal;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+
+	private:
+		static constexpr std::size_t group_size{ ci_impl::simd::group_size };
+		static constexpr signed char empty_slot{ -128 };
+		static constexpr signed char deleted_slot{ -2 };
+
+		//Uninitialised until the control byte says the slot is full
+		struct slot {
+			std::size_t hash;
+			alignas(value_type) unsigned char storage[sizeof(value_type)];
+
+			value_type& value() noexcept { return *std::launder(reinterpret_cast<value_type*>(storage)); }
+			const value_type& value() const noexcept { return *std::launder(reinterpret_cast<const value_type*>(storage)); }
+		};
+
+		std::unique_ptr<signed char[]> control;
+		std::unique_ptr<slot[]> slots;
+		std::size_t slot_count{ 0 };
+		std::size_t size_count{ 0 };
+		std::size_t deleted_count{ 0 };
+
+		static constexpr std::size_t npos{ static_cast<std::size_t>(-1) };
+		static constexpr std::size_t keep_probing{ npos - 1 };
+
+		//At most seven eighths full, counting deleted slots, so every probe sequence reaches an empty slot
+		static constexpr std::size_t max_load(std::size_t slots) noexcept {
+			return slots - slots / 8;
+		}
+
+		static std::size_t slots_for(std::size_t count) noexcept {
+			std::size_t slots{ group_size };
+			while (max_load(slots) < count) slots *= 2;
+			return slots;
+		}
+
+		//The low seven bits go in the control byte, and the rest pick the first group to probe
+		static signed char fingerprint(std::size_t hash) noexcept {
+			return static_cast<signed char>(hash & 0x7F);
+		}
+
+		//Triangular steps over a power of two number of groups visit every group once
+		template<typename Func>
+		std::size_t probe(std::size_t hash, Func&& func) const {
+			const std::size_t group_mask{ slot_count / group_size - 1 };
+			std::size_t group{ (hash >> 7) & group_mask };
+			for (std::size_t step = 1; ; ++step) {
+				const std::size_t found{ func(group * group_size, control.get() + group * group_size) };
+				if (found != keep_probing) return found;
+				group = (group + step) & group_mask;
+			}
+		}
+
+		template<typename OtherCharT>
+		std::size_t find_index(ci_impl::char_range<OtherCharT> key, std::size_t hash) const {
+			static_assert(std::is_same_v<OtherCharT, CharT>, "Keys must be of the same character type as the map");
+			if (size_count == 0) return npos;
+			const signed char wanted{ fingerprint(hash) };
+			return probe(hash, [&](std::size_t first, const signed char* group) -> std::size_t {
+				for (unsigned match = ci_impl::simd::match_control(group, wanted); match != 0; match &= match - 1) {
+					const std::size_t index{ first + ci_impl::simd::first_set_bit(match) };
+					const slot& candidate{ slots[index] };
+					if (candidate.hash == hash && ci_impl::equal_ranges(ci_impl::range_of(candidate.value().first), key)) return index;
+				}
+				return ci_impl::simd::match_control(group, empty_slot) != 0 ? npos : keep_probing;
+			});
+		}
+
+		std::size_t find_free(std::size_t hash) const noexcept {
+			return probe(hash, [](std::size_t first, const signed char* group) -> std::size_t {
+				const unsigned free{ ci_impl::simd::match_free(group) };
+				return free != 0 ? first + ci_impl::simd::first_set_bit(free) : keep_probing;
+			});
+		}
+
+		bool is_full(std::size_t index) const noexcept {
+			return control[index] >= 0;
+		}
+
+		void destroy_all() noexcept {
+			if constexpr (!std::is_trivially_destructible_v<value_type>) {
+				for (std::size_t i = 0; i < slot_count; ++i) {
+					if (is_full(i)) slots[i].value().~value_type();
+				}
+			}
+		}
+
+		//An empty table of the given size
+		static basic_ci_flat_map with_slots(std::size_t new_slot_count) {
+			basic_ci_flat_map out;
+			out.control.reset(new signed char[new_slot_count]);
+			out.slots.reset(new slot[new_slot_count]);
+			std::memset(out.control.get(), static_cast<unsigned char>(empty_slot), new_slot_count);
+			out.slot_count = new_slot_count;
+			return out;
+		}
+
+		//Where the mapped type moves without throwing, so does the whole entry. The key is moved out from under its const, as libc++ and Abseil do,
+		//since the old entry is destroyed straight after and nothing can see it. Otherwise the entries are copied, so if anything throws the map is left as it was.
+		void move_entries_to(basic_ci_flat_map& rebuilt) {
+			for (std::size_t i = 0; i < slot_count; ++i) {
+				if (!is_full(i)) continue;
+				value_type& source{ slots[i].value() };
+				const std::size_t index{ rebuilt.find_free(slots[i].hash) };
+				if constexpr (std::is_nothrow_move_constructible_v<T>) {
+					::new (static_cast<void*>(rebuilt.slots[index].storage)) value_type(std::move(const_cast<key_type&>(source.first)), std::move(source.second));
+				}
+				else {
+					::new (static_cast<void*>(rebuilt.slots[index].storage)) value_type(std::move_if_noexcept(source));
+				}
+				rebuilt.slots[index].hash = slots[i].hash;
+				rebuilt.control[index] = fingerprint(slots[i].hash);
+				++rebuilt.size_count;
+			}
+		}
+
+		void rehash_to(std::size_t new_slot_count) {
+			basic_ci_flat_map rebuilt{ with_slots(new_slot_count) };
+			move_entries_to(rebuilt);
+			swap(rebuilt);
+		}
+
+		//The number of slots the table needs to take one more entry, or zero if it already has room.
+		//Where much of the table is deleted slots, clearing them out is enough.
+		std::size_t slots_for_insert() const noexcept {
+			if (size_count + deleted_count < max_load(slot_count)) return 0;
+			return deleted_count > size_count / 2 && slot_count != 0 ? slot_count : slots_for(size_count + 1);
+		}
+
+		//Only where there is room for it
+		template<typename... Args>
+		std::size_t construct_new(std::size_t hash, Args&&... args) {
+			const std::size_t index{ find_free(hash) };
+			::new (static_cast<void*>(slots[index].storage)) value_type(std::forward<Args>(args)...);
+			slots[index].hash = hash;
+			if (control[index] == deleted_slot) --deleted_count;
+			control[index] = fingerprint(hash);
+			++size_count;
+			return index;
+		}
+
+		//The arguments may refer to an entry of this map, as in m.try_emplace(key, m.at(other)). So where the table has to be rebuilt,
+		//the new entry is constructed in the new table before any old entry is moved, and the entries it was made from are still there.
+		template<typename... Args>
+		std::size_t insert_new(std::size_t hash, Args&&... args) {
+			const std::size_t new_slot_count{ slots_for_insert() };
+			if (new_slot_count == 0) return construct_new(hash, std::forward<Args>(args)...);
+			basic_ci_flat_map rebuilt{ with_slots(new_slot_count) };
+			const std::size_t index{ rebuilt.construct_new(hash, std::forward<Args>(args)...) };
+			move_entries_to(rebuilt);
+			swap(rebuilt);
+			return index;
+		}
+
+		template<typename StrT>
+		static key_type make_key(const StrT& in) {
+			const auto range{ ci_impl::range_of(in) };
+			return key_type(range.data, range.size);
+		}
+
+		template<typename StrT>
+		static std::size_t hash_of(const StrT& in) {
+			return ci_impl::hash_range(ci_impl::range_of(in));
+		}
+
+		//A group with an empty slot has never been full, so no probe has passed it and the slot can be empty again
+		void erase_index(std::size_t index) noexcept {
+			slots[index].value().~value_type();
+			const std::size_t group_start{ index - index % group_size };
+			if (ci_impl::simd::match_control(control.get() + group_start, empty_slot) != 0) {
+				control[index] = empty_slot;
+			}
+			else {
+				control[index] = deleted_slot;
+				++deleted_count;
+			}
+			--size_count;
+		}
+
+		template<bool Const>
+		class iterator_impl {
+			friend class basic_ci_flat_map;
+			template<bool> friend class iterator_impl;
+
+			using map_pointer = std::conditional_t<Const, const basic_ci_flat_map*, basic_ci_flat_map*>;
+			map_pointer map{ nullptr };
+			std::size_t index{ 0 };
+
+			void skip_free() noexcept {
+				while (index < map->slot_count && !map->is_full(index)) ++index;
+			}
+
+			iterator_impl(map_pointer in_map, std::size_t in_index) noexcept : map{ in_map }, index{ in_index } {}
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = typename basic_ci_flat_map::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+			using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+			iterator_impl() = default;
+			//A mutable iterator converts to a const one, but not the other way
+			template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+			iterator_impl(const iterator_impl<OtherConst>& other) noexcept : map{ other.map }, index{ other.index } {}
+
+			reference operator*() const noexcept { return map->slots[index].value(); }
+			pointer operator->() const noexcept { return &map->slots[index].value(); }
+
+			iterator_impl& operator++() noexcept {
+				++index;
+				skip_free();
+				return *this;
+			}
+			iterator_impl operator++(int) noexcept {
+				auto copy{ *this };
+				++*this;
+				return copy;
+			}
+
+			friend bool operator==(const iterator_impl& lhs, const iterator_impl& rhs) noexcept { return lhs.index == rhs.index; }
+			friend bool operator!=(const iterator_impl& lhs, const iterator_impl& rhs) noexcept { return !(lhs == rhs); }
+		};
+
+	public:
+		using iterator = iterator_impl<false>;
+		using const_iterator = iterator_impl<true>;
+
+		basic_ci_flat_map() = default;
+
+		explicit basic_ci_flat_map(size_type expected) {
+			reserve(expected);
+		}
+
+		basic_ci_flat_map(std::initializer_list<value_type> init) {
+			reserve(init.size());
+			for (const auto& entry : init) insert(entry);
+		}
+
+		basic_ci_flat_map(const basic_ci_flat_map& other) {
+			reserve(other.size_count);
+			for (const auto& entry : other) insert_new(hash_of(entry.first), entry);
+		}
+
+		basic_ci_flat_map(basic_ci_flat_map&& other) noexcept {
+			swap(other);
+		}
+
+		basic_ci_flat_map& operator=(const basic_ci_flat_map& other) {
+			if (this != &other) {
+				basic_ci_flat_map copy{ other };
+				swap(copy);
+			}
+			return *this;
+		}
+
+		basic_ci_flat_map& operator=(basic_ci_flat_map&& other) noexcept {
+			if (this != &other) {
+				basic_ci_flat_map moved{ std::move(other) };
+				swap(moved);
+			}
+			return *this;
+		}
+
+		~basic_ci_flat_map() noexcept {
+			destroy_all();
+		}
+
+		void swap(basic_ci_flat_map& other) noexcept {
+			using std::swap;
+			swap(control, other.control);
+			swap(slots, other.slots);
+			swap(slot_count, other.slot_count);
+			swap(size_count, other.size_count);
+			swap(deleted_count, other.deleted_count);
+		}
+
+		friend void swap(basic_ci_flat_map& lhs, basic_ci_flat_map& rhs) noexcept { lhs.swap(rhs); }
+
+		iterator begin() noexcept {
+			iterator out{ this, 0 };
+			if (slot_count != 0) out.skip_free();
+			return out;
+		}
+		const_iterator begin() const noexcept {
+			const_iterator out{ this, 0 };
+			if (slot_count != 0) out.skip_free();
+			return out;
+		}
+		const_iterator cbegin() const noexcept { return begin(); }
+		iterator end() noexcept { return iterator{ this, slot_count }; }
+		const_iterator end() const noexcept { return const_iterator{ this, slot_count }; }
+		const_iterator cend() const noexcept { return end(); }
+
+		bool empty() const noexcept { return size_count == 0; }
+		size_type size() const noexcept { return size_count; }
+		size_type capacity() const noexcept { return max_load(slot_count); }
+
+		void clear() noexcept {
+			destroy_all();
+			if (slot_count != 0) std::memset(control.get(), static_cast<unsigned char>(empty_slot), slot_count);
+			size_count = 0;
+			deleted_count = 0;
+		}
+
+		//Makes room for at least count entries without growing again
+		void reserve(size_type count) {
+			if (count + deleted_count <= max_load(slot_count)) return;
+			rehash_to(slots_for(count > size_count ? count : size_count));
+		}
+
+		template<typename StrT>
+		iterator find(const StrT& key) {
+			const std::size_t index{ find_index(ci_impl::range_of(key), hash_of(key)) };
+			return index == npos ? end() : iterator{ this, index };
+		}
+		template<typename StrT>
+		const_iterator find(const StrT& key) const {
+			const std::size_t index{ find_index(ci_impl::range_of(key), hash_of(key)) };
+			return index == npos ? end() : const_iterator{ this, index };
+		}
+
+		template<typename StrT>
+		bool contains(const StrT& key) const {
+			return find_index(ci_impl::range_of(key), hash_of(key)) != npos;
+		}
+		template<typename StrT>
+		size_type count(const StrT& key) const {
+			return contains(key) ? 1 : 0;
+		}
+
+		template<typename StrT>
+		T& at(const StrT& key) {
+			const std::size_t index{ find_index(ci_impl::range_of(key), hash_of(key)) };
+			if (index == npos) throw std::out_of_range("dp::ci_flat_map::at: key not found");
+			return slots[index].value().second;
+		}
+		template<typename StrT>
+		const T& at(const StrT& key) const {
+			const std::size_t index{ find_index(ci_impl::range_of(key), hash_of(key)) };
+			if (index == npos) throw std::out_of_range("dp::ci_flat_map::at: key not found");
+			return slots[index].value().second;
+		}
+
+		//The key is only made into a key_type if it isn't already in the map. The arguments may refer to entries of the map,
+		//as the new entry is constructed before a rehash invalidates them.
+		template<typename StrT, typename... Args>
+		std::pair<iterator, bool> try_emplace(const StrT& key, Args&&... args) {
+			const std::size_t hash{ hash_of(key) };
+			const std::size_t found{ find_index(ci_impl::range_of(key), hash) };
+			if (found != npos) return { iterator{ this, found }, false };
+			const std::size_t index{ insert_new(hash, std::piecewise_construct, std::forward_as_tuple(make_key(key)), std::forward_as_tuple(std::forward<Args>(args)...)) };
+			return { iterator{ this, index }, true };
+		}
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+			const std::size_t hash{ hash_of(key) };
+			const std::size_t found{ find_index(ci_impl::range_of(key), hash) };
+			if (found != npos) return { iterator{ this, found }, false };
+			const std::size_t index{ insert_new(hash, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...)) };
+			return { iterator{ this, index }, true };
+		}
+
+		std::pair<iterator, bool> insert(const value_type& entry) {
+			return try_emplace(entry.first, entry.second);
+		}
+		std::pair<iterator, bool> insert(value_type&& entry) {
+			const std::size_t hash{ hash_of(entry.first) };
+			const std::size_t found{ find_index(ci_impl::range_of(entry.first), hash) };
+			if (found != npos) return { iterator{ this, found }, false };
+			return { iterator{ this, insert_new(hash, std::move(entry)) }, true };
+		}
+
+		template<typename StrT, typename M>
+		std::pair<iterator, bool> insert_or_assign(StrT&& key, M&& obj) {
+			auto result{ try_emplace(std::forward<StrT>(key), std::forward<M>(obj)) };
+			if (!result.second) result.first->second = std::forward<M>(obj);
+			return result;
+		}
+
+		template<typename StrT>
+		T& operator[](StrT&& key) {
+			return try_emplace(std::forward<StrT>(key)).first->second;
+		}
+
+		template<typename StrT>
+		size_type erase(const StrT& key) {
+			const std::size_t index{ find_index(ci_impl::range_of(key), hash_of(key)) };
+			if (index == npos) return 0;
+			erase_index(index);
+			return 1;
+		}
+
+		iterator erase(const_iterator pos) noexcept {
+			erase_index(pos.index);
+			iterator next{ this, pos.index };
+			next.skip_free();
+			return next;
+		}
+		iterator erase(iterator pos) noexcept {
+			return erase(const_iterator{ pos });
+		}
+	};
+
+	template<typename T>
+	using ci_flat_map = basic_ci_flat_map<char, T>;
+	template<typename T>
+	using ci_wflat_map = basic_ci_flat_map<wchar_t, T>;
+
+}
+
+#endif
@@ -8,10 +8,16 @@
 *   Full documentation here: https://github.com/DryPerspective/C_Builder_Extras/wiki/CI_Traits
 */
 
+#ifdef __BORLANDC__
+#include "bits/borland_version_defs.h"
+#endif
+
 #include <string>
 #include <cctype>
 #include <cwctype>
 
+#include "bits/ci_simd.h"
+
 //Embarcadero don't define the standard testing macros...
 #if defined(__cpp_lib_string_view) || defined(DP_CBUILDER11)
 #include <string_view>
@@ -19,46 +25,151 @@
 
 #if defined(DB_CBUILDER11) || __cplusplus >= 201103L || defined(_MSC_VER)
 #define DP_CONSTEXPR constexpr
+#define DP_CONSTEXPR_TABLES
+#define DP_CI_UNORDERED
+#define DP_CI_DELETED_FUNCTIONS
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include "bits/ci_hash.h"
 #else
 #define DP_CONSTEXPR
 #endif
 
+//The vector kernels can't run in a constant expression, so where we can tell we're in one we stay on the scalar loop.
+//Where we can't tell, we take the faster runtime path and give up constant evaluation of compare and find.
+//Before C++11 nothing is constexpr, so there's nothing to tell.
+#if defined(DP_CONSTEXPR_TABLES) && defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define DP_CI_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#endif
+#if defined(DP_CONSTEXPR_TABLES) && !defined(DP_CI_CONSTANT_EVALUATED) && ((defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925))
+#define DP_CI_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#ifndef DP_CI_CONSTANT_EVALUATED
+#define DP_CI_CONSTANT_EVALUATED() false
+#endif
+
+
+//ASCII letters fold to lower case, as they always have
+#define DP_CI_NARROW_FOLD_TABLE \
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, \
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, \
+	0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, \
+	0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F, \
+	0x40, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F, \
+	0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F, \
+	0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F, \
+	0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x7F, \
+	0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x8B, 0x8C, 0x8D, 0x8E, 0x8F, \
+	0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0x9B, 0x9C, 0x9D, 0x9E, 0x9F, \
+	0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xAB, 0xAC, 0xAD, 0xAE, 0xAF, \
+	0xB0, 0xB1, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xBB, 0xBC, 0xBD, 0xBE, 0xBF, \
+	0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF, \
+	0xD0, 0xD1, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xDB, 0xDC, 0xDD, 0xDE, 0xDF, \
+	0xE0, 0xE1, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xEB, 0xEC, 0xED, 0xEE, 0xEF, \
+	0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF
+
+//Every Latin-1 character to its simple upper case, which for the micro sign and y-diaeresis is outside Latin-1
+#define DP_CI_WIDE_FOLD_TABLE \
+	0x0000, 0x0001, 0x0002, 0x0003, 0x0004, 0x0005, 0x0006, 0x0007, 0x0008, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, 0x000F, \
+	0x0010, 0x0011, 0x0012, 0x0013, 0x0014, 0x0015, 0x0016, 0x0017, 0x0018, 0x0019, 0x001A, 0x001B, 0x001C, 0x001D, 0x001E, 0x001F, \
+	0x0020, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0027, 0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F, \
+	0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037, 0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F, \
+	0x0040, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047, 0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F, \
+	0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057, 0x0058, 0x0059, 0x005A, 0x005B, 0x005C, 0x005D, 0x005E, 0x005F, \
+	0x0060, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047, 0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F, \
+	0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057, 0x0058, 0x0059, 0x005A, 0x007B, 0x007C, 0x007D, 0x007E, 0x007F, \
+	0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087, 0x0088, 0x0089, 0x008A, 0x008B, 0x008C, 0x008D, 0x008E, 0x008F, \
+	0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097, 0x0098, 0x0099, 0x009A, 0x009B, 0x009C, 0x009D, 0x009E, 0x009F, \
+	0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7, 0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF, \
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x039C, 0x00B6, 0x00B7, 0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF, \
+	0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7, 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF, \
+	0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7, 0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF, \
+	0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7, 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF, \
+	0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00F7, 0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x0178
 
 
 namespace dp {
 
-	//At present we only support char and wchar_t; as unicode is its own kettle of fish.
-	template<typename CharT>
-	class ci_traits : public std::char_traits<CharT> {
+	namespace ci_impl {
+
+		/*
+		*  Case folding by table lookup, so comparing a character is a load rather than a chain of range checks.
+		*  For char we fold ASCII only, as we can't know which code page the text is in. For wchar_t the table covers Latin-1,
+		*  which is most of what turns up in practice, and anything beyond it falls back to towupper and the current locale.
+		*  A template only so the tables can be defined in a header before C++17 inline variables.
+		*/
+		template<typename Dummy = void>
+		struct fold_tables {
+#ifdef DP_CONSTEXPR_TABLES
+			static constexpr unsigned char narrow[256] = { DP_CI_NARROW_FOLD_TABLE };
+			static constexpr unsigned short wide[256] = { DP_CI_WIDE_FOLD_TABLE };
+#else
+			static const unsigned char narrow[256];
+			static const unsigned short wide[256];
+#endif
+		};
 
-		DP_CONSTEXPR static char upper(char in) {
-			return (in > 'A' && in < 'Z') ? (in + 'a' - 'A') : in;
+#ifdef DP_CONSTEXPR_TABLES
+		template<typename Dummy>
+		constexpr unsigned char fold_tables<Dummy>::narrow[256];
+		template<typename Dummy>
+		constexpr unsigned short fold_tables<Dummy>::wide[256];
+#else
+		template<typename Dummy>
+		const unsigned char fold_tables<Dummy>::narrow[256] = { DP_CI_NARROW_FOLD_TABLE };
+		template<typename Dummy>
+		const unsigned short fold_tables<Dummy>::wide[256] = { DP_CI_WIDE_FOLD_TABLE };
+#endif
+
+		//Folded as unsigned, so that lt orders the same way as std::char_traits
+		DP_CONSTEXPR inline unsigned char fold(char in) {
+			return fold_tables<>::narrow[static_cast<unsigned char>(in)];
 		}
-		static wchar_t upper(wchar_t in) {
-			return std::towupper(in);
+		inline unsigned long fold(wchar_t in) {
+			const unsigned long code = static_cast<unsigned long>(in);
+			return code < 256 ? fold_tables<>::wide[code] : static_cast<unsigned long>(std::towupper(static_cast<std::wint_t>(in)));
 		}
 
+		//Hands fold to the vector kernels, which fall back on it for anything they can't fold themselves
+		struct folder {
+			static unsigned long apply(char in) {
+				return fold(in);
+			}
+			static unsigned long apply(wchar_t in) {
+				return fold(in);
+			}
+		};
+	}
+
+	//At present we only support char and wchar_t; as unicode is its own kettle of fish.
+	template<typename CharT>
+	class ci_traits : public std::char_traits<CharT> {
 	public:
 		DP_CONSTEXPR static bool eq(CharT lhs, CharT rhs) {
-			return upper(lhs) == upper(rhs);
+			return ci_impl::fold(lhs) == ci_impl::fold(rhs);
 		}
 		DP_CONSTEXPR static bool lt(CharT lhs, CharT rhs) {
-			return upper(lhs) < upper(rhs);
+			return ci_impl::fold(lhs) < ci_impl::fold(rhs);
 		}
 		DP_CONSTEXPR static int compare(const CharT* lhs, const CharT* rhs, std::size_t n) {
-			while (n-- != 0) {
-				if (upper(*lhs) < upper(*rhs)) return -1;
-				if (upper(*lhs) > upper(*rhs)) return 1;
-				++lhs;
-				++rhs;
+			if (!DP_CI_CONSTANT_EVALUATED()) return ci_impl::simd::compare<ci_impl::folder>(lhs, rhs, n);
+			for (std::size_t i = 0; i < n; ++i) {
+				const unsigned long lhs_folded = ci_impl::fold(lhs[i]);
+				const unsigned long rhs_folded = ci_impl::fold(rhs[i]);
+				if (lhs_folded != rhs_folded) return lhs_folded < rhs_folded ? -1 : 1;
 			}
 			return 0;
 		}
 		DP_CONSTEXPR static const CharT* find(const CharT* str, std::size_t n, CharT ch) {
-			const CharT upper_ch = upper(ch);
-			while (n-- != 0) {
-				if (upper(*str) == upper_ch) return str;
-				++str;
+			if (!DP_CI_CONSTANT_EVALUATED()) return ci_impl::simd::find<ci_impl::folder>(str, n, ch);
+			const unsigned long folded_ch = ci_impl::fold(ch);
+			for (std::size_t i = 0; i < n; ++i) {
+				if (ci_impl::fold(str[i]) == folded_ch) return str + i;
 			}
 			return NULL;
 		}
@@ -71,9 +182,20 @@ namespace dp {
 
 	//Because we're in C++98 we don't have std::string_view as a standardised tool for converting string types around.
 	//As such, we need to template the class this cast function uses as its stringlike.
-	//This way it'll work with std::string, std::string_view, and a custom string_view which follows the pattern.
+	//This way it'll work with std::string_view, and a custom string_view which follows the pattern. Views are cheap to copy, so this costs nothing.
+	//std::string has its own overload below.
+	namespace ci_impl {
+		//Newer compilers will match std::basic_string to StrT through its default allocator, so we step aside for its own overload
+		template<typename StrT, typename Result>
+		struct unless_basic_string {
+			typedef Result type;
+		};
+		template<typename CharT, typename Traits, typename Alloc, typename Result>
+		struct unless_basic_string<std::basic_string<CharT, Traits, Alloc>, Result> {};
+	}
+
 	template<typename Dest_Traits, typename CharT, typename Src_Traits, template<typename, typename> class StrT>
-	DP_CONSTEXPR StrT<CharT, Dest_Traits> traits_cast(StrT<CharT, Src_Traits> in) {
+	DP_CONSTEXPR typename ci_impl::unless_basic_string<StrT<CharT, Src_Traits>, StrT<CharT, Dest_Traits> >::type traits_cast(StrT<CharT, Src_Traits> in) {
 		return StrT<CharT, Dest_Traits>(in.data(), in.size());
 	}
 
@@ -98,10 +220,187 @@ namespace dp {
 
 #endif
 
+#if defined(__cpp_lib_string_view) || defined(DP_CBUILDER11)
+#define DP_CI_STRING_VIEW std::basic_string_view
+#else
+#define DP_CI_STRING_VIEW basic_string_view
+#endif
+
+	//An owning string becomes an owning string with the new traits and the same allocator. Taken by reference, so the characters are
+	//copied the once. A temporary is copied too, as there's no handing storage between basic_strings with different traits.
+	template<typename Dest_Traits, typename CharT, typename Src_Traits, typename Alloc>
+	std::basic_string<CharT, Dest_Traits, Alloc> traits_cast(const std::basic_string<CharT, Src_Traits, Alloc>& in) {
+		return std::basic_string<CharT, Dest_Traits, Alloc>(in.data(), in.size(), in.get_allocator());
+	}
+
+	//A view of the same characters with the new traits, so switching between case-sensitive and case-insensitive comparison copies nothing.
+	//As with any view, the string must outlive it.
+	template<typename Dest_Traits, typename CharT, typename Src_Traits, typename Alloc>
+	DP_CI_STRING_VIEW<CharT, Dest_Traits> traits_view(const std::basic_string<CharT, Src_Traits, Alloc>& in) {
+		return DP_CI_STRING_VIEW<CharT, Dest_Traits>(in.data(), in.size());
+	}
+	template<typename Dest_Traits, typename CharT, typename Src_Traits>
+	DP_CONSTEXPR DP_CI_STRING_VIEW<CharT, Dest_Traits> traits_view(DP_CI_STRING_VIEW<CharT, Src_Traits> in) {
+		return DP_CI_STRING_VIEW<CharT, Dest_Traits>(in.data(), in.size());
+	}
+	template<typename Dest_Traits, typename CharT>
+	DP_CONSTEXPR DP_CI_STRING_VIEW<CharT, Dest_Traits> traits_view(const CharT* in) {
+		return DP_CI_STRING_VIEW<CharT, Dest_Traits>(in, std::char_traits<CharT>::length(in));
+	}
 
+#ifdef __BORLANDC__
+	template<typename Dest_Traits>
+	DP_CI_STRING_VIEW<char, Dest_Traits> traits_view(const AnsiString& in) {
+		return DP_CI_STRING_VIEW<char, Dest_Traits>(in.c_str(), static_cast<std::size_t>(in.Length()));
+	}
+#ifdef DP_CBUILDER10
+	template<typename Dest_Traits>
+	DP_CI_STRING_VIEW<wchar_t, Dest_Traits> traits_view(const UnicodeString& in) {
+		return DP_CI_STRING_VIEW<wchar_t, Dest_Traits>(in.c_str(), static_cast<std::size_t>(in.Length()));
+	}
+#endif
+#endif
+
+	//A view of a temporary string would dangle by the end of the statement
+#ifdef DP_CI_DELETED_FUNCTIONS
+	template<typename Dest_Traits, typename CharT, typename Src_Traits, typename Alloc>
+	void traits_view(const std::basic_string<CharT, Src_Traits, Alloc>&&) = delete;
+#ifdef __BORLANDC__
+	template<typename Dest_Traits>
+	void traits_view(const AnsiString&&) = delete;
+#ifdef DP_CBUILDER10
+	template<typename Dest_Traits>
+	void traits_view(const UnicodeString&&) = delete;
+#endif
+#endif
+#endif
+
+
+	//ci_hash mixes with 64-bit arithmetic, so like the unordered containers it needs C++11
+#ifdef DP_CI_UNORDERED
+	namespace ci_impl {
+
+		//A pointer and a length, so ci_hash and ci_equal can take any kind of string
+		template<typename CharT>
+		struct char_range {
+			const CharT* data;
+			std::size_t size;
+		};
+
+		template<typename CharT>
+		char_range<CharT> make_range(const CharT* data, std::size_t size) {
+			char_range<CharT> out = { data, size };
+			return out;
+		}
+
+		template<typename CharT, typename Traits, typename Alloc>
+		char_range<CharT> range_of(const std::basic_string<CharT, Traits, Alloc>& in) {
+			return make_range(in.data(), in.size());
+		}
+#if defined(__cpp_lib_string_view) || defined(DP_CBUILDER11)
+		template<typename CharT, typename Traits>
+		char_range<CharT> range_of(std::basic_string_view<CharT, Traits> in) {
+			return make_range(in.data(), in.size());
+		}
+#else
+		template<typename CharT, typename Traits>
+		char_range<CharT> range_of(const basic_string_view<CharT, Traits>& in) {
+			return make_range(in.data(), in.size());
+		}
+#endif
+		template<typename CharT>
+		char_range<CharT> range_of(const CharT* in) {
+			return make_range(in, std::char_traits<CharT>::length(in));
+		}
+
+		inline std::size_t hash_range(char_range<char> in) {
+			return hash::chars(in.data, in.size);
+		}
+		inline std::size_t hash_range(char_range<wchar_t> in) {
+			return hash::chars<folder>(in.data, in.size);
+		}
+
+		template<typename CharT>
+		bool equal_ranges(char_range<CharT> lhs, char_range<CharT> rhs) {
+			return lhs.size == rhs.size && ci_traits<CharT>::compare(lhs.data, rhs.data, lhs.size) == 0;
+		}
+	}
+
+	//Hashes a string of char or wchar_t ignoring case, such that strings which ci_traits finds equal hash the same whatever their traits.
+	//Both this and ci_equal are transparent, so a container keyed on ci_string can be searched with a std::string, a string_view or a literal.
+	struct ci_hash {
+		typedef void is_transparent;
+
+		template<typename StrT>
+		std::size_t operator()(const StrT& in) const {
+			return ci_impl::hash_range(ci_impl::range_of(in));
+		}
+	};
+
+	struct ci_equal {
+		typedef void is_transparent;
+
+		template<typename LhsT, typename RhsT>
+		bool operator()(const LhsT& lhs, const RhsT& rhs) const {
+			return ci_impl::equal_ranges(ci_impl::range_of(lhs), ci_impl::range_of(rhs));
+		}
+	};
+
+	//Standard library containers only use a transparent hash to look up by another type from C++20.
+	//Before that, a lookup must be by the key type itself.
+	template<typename T, typename Alloc = std::allocator<std::pair<const ci_string, T> > >
+	using ci_unordered_map = std::unordered_map<ci_string, T, ci_hash, ci_equal, Alloc>;
+	template<typename T, typename Alloc = std::allocator<std::pair<const ci_wstring, T> > >
+	using ci_wunordered_map = std::unordered_map<ci_wstring, T, ci_hash, ci_equal, Alloc>;
+
+	template<typename Alloc = std::allocator<ci_string> >
+	using ci_unordered_set = std::unordered_set<ci_string, ci_hash, ci_equal, Alloc>;
+	template<typename Alloc = std::allocator<ci_wstring> >
+	using ci_wunordered_set = std::unordered_set<ci_wstring, ci_hash, ci_equal, Alloc>;
+#endif
+
+}
+
+#ifdef DP_CI_UNORDERED
+//So the case-insensitive strings work as keys in containers which use the default hash
+namespace std {
+	template<>
+	struct hash<dp::ci_string> {
+		std::size_t operator()(const dp::ci_string& in) const {
+			return dp::ci_hash()(in);
+		}
+	};
+	template<>
+	struct hash<dp::ci_wstring> {
+		std::size_t operator()(const dp::ci_wstring& in) const {
+			return dp::ci_hash()(in);
+		}
+	};
+#if defined(__cpp_lib_string_view) || defined(DP_CBUILDER11)
+	template<>
+	struct hash<dp::ci_string_view> {
+		std::size_t operator()(dp::ci_string_view in) const {
+			return dp::ci_hash()(in);
+		}
+	};
+	template<>
+	struct hash<dp::ci_wstring_view> {
+		std::size_t operator()(dp::ci_wstring_view in) const {
+			return dp::ci_hash()(in);
+		}
+	};
+#endif
 }
+#endif
 
 
 #undef DP_CONSTEXPR
+#undef DP_CONSTEXPR_TABLES
+#undef DP_CI_CONSTANT_EVALUATED
+#undef DP_CI_UNORDERED
+#undef DP_CI_DELETED_FUNCTIONS
+#undef DP_CI_STRING_VIEW
+#undef DP_CI_NARROW_FOLD_TABLE
+#undef DP_CI_WIDE_FOLD_TABLE
 
 #endif
\ No newline at end of file
@@ -0,0 +1,300 @@
+#ifndef DP_MAPPED_FILE
+#define DP_MAPPED_FILE
+
+/*
+*  A read-only view of the contents of a file, intended to feed convert_to and the field parser without first copying the whole
+*  file into a std::string. Where the platform supports it the file is memory-mapped and the OS is told we will read it sequentially,
+*  so readahead can keep ahead of the parser. Otherwise the file is read into a buffer owned by the view, which is no worse than
+*  what we would have done anyway.
+*
+*  Like a std::ifstream, failing to open the file is not an error in itself - check is_open() before use.
+*/
+
+#ifdef __BORLANDC__
+#include "bits/borland_version_defs.h"
+#endif
+
+#if !(defined(DP_CBUILDER11) || __cplusplus >= 201703L || _MSVC_LANG >= 201703L)
+#error "dp::mapped_file requires C++17"
+#endif
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdio>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+
+#if defined(_WIN32)
+#define DP_MAPPED_FILE_WINDOWS
+//Keep windows.h from defining min and max as macros, and from pulling in everything else besides; but only for our own include
+#ifndef NOMINMAX
+#define NOMINMAX
+#define DP_MAPPED_FILE_NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#define DP_MAPPED_FILE_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#ifdef DP_MAPPED_FILE_NOMINMAX
+#undef NOMINMAX
+#undef DP_MAPPED_FILE_NOMINMAX
+#endif
+#ifdef DP_MAPPED_FILE_LEAN_AND_MEAN
+#undef WIN32_LEAN_AND_MEAN
+#undef DP_MAPPED_FILE_LEAN_AND_MEAN
+#endif
+#elif defined(__has_include)
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#define DP_MAPPED_FILE_POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace dp {
+
+	enum class access_pattern {
+		normal,
+		sequential,
+		random
+	};
+
+	//A range of the records in a block of text, split on the terminator. The terminator itself is not part of any record,
+	//and a trailing terminator at the end of the text does not produce an empty final record.
+	class record_range {
+		std::string_view text;
+		char terminator;
+
+	public:
+		class iterator {
+			std::string_view current{};
+			const char* next{ nullptr };
+			const char* last{ nullptr };
+			char terminator{ '\n' };
+
+			void advance() {
+				if (next == last) {
+					current = std::string_view{};
+					return;
+				}
+				const auto remaining{ static_cast<std::size_t>(last - next) };
+				const auto found{ std::char_traits<char>::find(next, remaining, terminator) };
+				const auto length{ found ? static_cast<std::size_t>(found - next) : remaining };
+				current = std::string_view{ next, length };
+				next = found ? found + 1 : last;
+				if (terminator == '\n' && !current.empty() && current.back() == '\r') current.remove_suffix(1);
+			}
+
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = std::string_view;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const std::string_view*;
+			using reference = const std::string_view&;
+
+			iterator() = default;
+			iterator(std::string_view in_text, char in_terminator) : next{ in_text.data() }, last{ in_text.data() + in_text.size() }, terminator{ in_terminator } {
+				if (in_text.empty()) next = last = nullptr;
+				advance();
+			}
+
+			reference operator*() const { return current; }
+			pointer operator->() const { return &current; }
+
+			iterator& operator++() {
+				advance();
+				return *this;
+			}
+			iterator operator++(int) {
+				auto copy{ *this };
+				advance();
+				return copy;
+			}
+
+			//Every record, even an empty one, points somewhere distinct in the text. The end iterator points nowhere.
+			friend bool operator==(const iterator& lhs, const iterator& rhs) { return lhs.current.data() == rhs.current.data(); }
+			friend bool operator!=(const iterator& lhs, const iterator& rhs) { return !(lhs == rhs); }
+		};
+
+		record_range(std::string_view in_text, char in_terminator = '\n') : text{ in_text }, terminator{ in_terminator } {}
+
+		iterator begin() const { return iterator{ text, terminator }; }
+		iterator end() const { return iterator{}; }
+	};
+
+
+
+	class mapped_file {
+		const char* first{ nullptr };
+		std::size_t length{ 0 };
+		bool open{ false };
+		bool mapped{ false };
+
+		//Used when the file could not be mapped
+		std::vector<char> buffer;
+
+#if defined(DP_MAPPED_FILE_WINDOWS)
+		HANDLE file_handle{ INVALID_HANDLE_VALUE };
+		HANDLE mapping_handle{ nullptr };
+#endif
+
+		bool read_fallback(const char* path) {
+			std::FILE* file{ std::fopen(path, "rb") };
+			if (!file) return false;
+			char chunk[64 * 1024];
+			for (std::size_t count = std::fread(chunk, 1, sizeof(chunk), file); count > 0; count = std::fread(chunk, 1, sizeof(chunk), file)) {
+				buffer.insert(buffer.end(), chunk, chunk + count);
+			}
+			const bool success{ std::ferror(file) == 0 };
+			std::fclose(file);
+			if (!success) {
+				buffer.clear();
+				return false;
+			}
+			first = buffer.data();
+			length = buffer.size();
+			return true;
+		}
+
+#if defined(DP_MAPPED_FILE_WINDOWS)
+		bool map(const char* path, access_pattern hint) {
+			DWORD flags{ FILE_ATTRIBUTE_NORMAL };
+			if (hint == access_pattern::sequential) flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+			else if (hint == access_pattern::random) flags |= FILE_FLAG_RANDOM_ACCESS;
+			file_handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+			if (file_handle == INVALID_HANDLE_VALUE) return false;
+
+			LARGE_INTEGER file_size;
+			if (!GetFileSizeEx(file_handle, &file_size)) return false;
+			//An empty file cannot be mapped, but it is still a perfectly good empty view
+			if (file_size.QuadPart == 0) return true;
+			mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping_handle) return false;
+			const void* view{ MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0) };
+			if (!view) return false;
+			first = static_cast<const char*>(view);
+			length = static_cast<std::size_t>(file_size.QuadPart);
+			mapped = true;
+			return true;
+		}
+#elif defined(DP_MAPPED_FILE_POSIX)
+		bool map(const char* path, access_pattern hint) {
+			const int descriptor{ ::open(path, O_RDONLY) };
+			if (descriptor < 0) return false;
+			struct stat file_info;
+			//Files which report a size of zero may still have content (e.g. /proc), so leave those to the fallback
+			bool success{ ::fstat(descriptor, &file_info) == 0 && S_ISREG(file_info.st_mode) && file_info.st_size > 0 };
+			if (success) {
+				void* view{ ::mmap(nullptr, static_cast<std::size_t>(file_info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0) };
+				if (view != MAP_FAILED) {
+					first = static_cast<const char*>(view);
+					length = static_cast<std::size_t>(file_info.st_size);
+					mapped = true;
+					if (hint == access_pattern::sequential) ::madvise(view, length, MADV_SEQUENTIAL);
+					else if (hint == access_pattern::random) ::madvise(view, length, MADV_RANDOM);
+				}
+				else {
+					success = false;
+				}
+			}
+			//The mapping keeps its own reference to the file
+			::close(descriptor);
+			return success;
+		}
+#endif
+
+		void release() noexcept {
+#if defined(DP_MAPPED_FILE_WINDOWS)
+			if (mapped) UnmapViewOfFile(first);
+			if (mapping_handle) CloseHandle(mapping_handle);
+			if (file_handle != INVALID_HANDLE_VALUE) CloseHandle(file_handle);
+			mapping_handle = nullptr;
+			file_handle = INVALID_HANDLE_VALUE;
+#elif defined(DP_MAPPED_FILE_POSIX)
+			if (mapped) ::munmap(const_cast<char*>(first), length);
+#endif
+			mapped = false;
+			buffer.clear();
+			first = nullptr;
+			length = 0;
+			open = false;
+		}
+
+		void swap(mapped_file& other) noexcept {
+			using std::swap;
+			swap(first, other.first);
+			swap(length, other.length);
+			swap(open, other.open);
+			swap(mapped, other.mapped);
+			swap(buffer, other.buffer);
+#if defined(DP_MAPPED_FILE_WINDOWS)
+			swap(file_handle, other.file_handle);
+			swap(mapping_handle, other.mapping_handle);
+#endif
+		}
+
+	public:
+		mapped_file() = default;
+
+		explicit mapped_file(const char* path, access_pattern hint = access_pattern::sequential) {
+#if defined(DP_MAPPED_FILE_WINDOWS) || defined(DP_MAPPED_FILE_POSIX)
+			open = map(path, hint);
+			//Some files (pipes, special files, some network shares) can't be mapped, but can still be read
+			if (!open) {
+				release();
+				open = read_fallback(path);
+			}
+#else
+			static_cast<void>(hint);
+			open = read_fallback(path);
+#endif
+		}
+		explicit mapped_file(const std::string& path, access_pattern hint = access_pattern::sequential) : mapped_file(path.c_str(), hint) {}
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		mapped_file(mapped_file&& other) noexcept {
+			swap(other);
+		}
+		mapped_file& operator=(mapped_file&& other) noexcept {
+			if (this != &other) {
+				release();
+				swap(other);
+			}
+			return *this;
+		}
+
+		~mapped_file() noexcept {
+			release();
+		}
+
+		bool is_open() const noexcept { return open; }
+		explicit operator bool() const noexcept { return open; }
+
+		const char* data() const noexcept { return first; }
+		std::size_t size() const noexcept { return length; }
+		bool empty() const noexcept { return length == 0; }
+
+		const char* begin() const noexcept { return first; }
+		const char* end() const noexcept { return first + length; }
+
+		std::string_view view() const noexcept { return std::string_view{ first, length }; }
+		operator std::string_view() const noexcept { return view(); }
+
+		//Records split on the terminator, with "\r\n" line endings handled when splitting on '\n'
+		record_range records(char terminator = '\n') const { return record_range{ view(), terminator }; }
+		record_range lines() const { return records('\n'); }
+	};
+
+}
+
+#undef DP_MAPPED_FILE_WINDOWS
+#undef DP_MAPPED_FILE_POSIX
+
+#endif
@@ -0,0 +1,93 @@
+/*
+*  Checks enum_names lookups in both directions on a 400-name enum with case-insensitive matching, which is large enough
+*  to exercise the perfect hash tables. Alongside the generated names are pairs which ci_char_traits tells apart but which
+*  differ only in bit 5, so would collide if the hash folded more than 'A' to 'Z'.
+*/
+
+#include "convert.h"
+#include "ci_traits.h"
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+enum class token : int {};
+
+#define DP_TEST_ENTRY(row, column) { "tok" #row "_" #column, token{ row * 20 + column } }
+#define DP_TEST_ROW(row) DP_TEST_ENTRY(row, 0), DP_TEST_ENTRY(row, 1), DP_TEST_ENTRY(row, 2), DP_TEST_ENTRY(row, 3), DP_TEST_ENTRY(row, 4), \
+	DP_TEST_ENTRY(row, 5), DP_TEST_ENTRY(row, 6), DP_TEST_ENTRY(row, 7), DP_TEST_ENTRY(row, 8), DP_TEST_ENTRY(row, 9), \
+	DP_TEST_ENTRY(row, 10), DP_TEST_ENTRY(row, 11), DP_TEST_ENTRY(row, 12), DP_TEST_ENTRY(row, 13), DP_TEST_ENTRY(row, 14), \
+	DP_TEST_ENTRY(row, 15), DP_TEST_ENTRY(row, 16), DP_TEST_ENTRY(row, 17), DP_TEST_ENTRY(row, 18), DP_TEST_ENTRY(row, 19)
+
+template<>
+struct dp::enum_names<token> {
+	using traits_type = dp::ci_char_traits;
+	static constexpr dp::enum_entry<token> entries[]{
+		DP_TEST_ROW(0), DP_TEST_ROW(1), DP_TEST_ROW(2), DP_TEST_ROW(3), DP_TEST_ROW(4), DP_TEST_ROW(5), DP_TEST_ROW(6), DP_TEST_ROW(7),
+		DP_TEST_ROW(8), DP_TEST_ROW(9), DP_TEST_ROW(10), DP_TEST_ROW(11), DP_TEST_ROW(12), DP_TEST_ROW(13), DP_TEST_ROW(14), DP_TEST_ROW(15),
+		DP_TEST_ROW(16), DP_TEST_ROW(17), DP_TEST_ROW(18), DP_TEST_ROW(19),
+		{ "x[1]", token{ 1000 } }, { "x{1}", token{ 1001 } },
+		{ "a@", token{ 1002 } }, { "a`", token{ 1003 } },
+		{ "p\\q", token{ 1004 } }, { "p|q", token{ 1005 } },
+		{ "u^", token{ 1006 } }, { "u~", token{ 1007 } },
+		{ "_id", token{ 1008 } }, { "\x7Fid", token{ 1009 } },
+		{ "\xC3\x89t\xC3\xA9", token{ 1010 } }, { "\xC3\xA9t\xC3\xA9", token{ 1011 } }
+	};
+};
+
+#undef DP_TEST_ROW
+#undef DP_TEST_ENTRY
+
+namespace {
+
+	std::size_t failures{ 0 };
+
+	void expect_name(std::string_view name, int value) {
+		const auto found{ dp::try_convert_to<token>(name) };
+		if (!found.has_value() || static_cast<int>(*found) != value) {
+			std::printf("FAIL \"%.*s\" should read as %d\n", static_cast<int>(name.size()), name.data(), value);
+			++failures;
+		}
+	}
+
+	void expect_value(int value, std::string_view name) {
+		if (dp::convert_to<std::string_view>(token{ value }) != name) {
+			std::printf("FAIL %d should be named \"%.*s\"\n", value, static_cast<int>(name.size()), name.data());
+			++failures;
+		}
+	}
+
+	void expect_no_name(std::string_view name) {
+		if (dp::try_convert_to<token>(name).has_value()) {
+			std::printf("FAIL \"%.*s\" should not match any name\n", static_cast<int>(name.size()), name.data());
+			++failures;
+		}
+	}
+
+}
+
+int main() {
+	for (int row = 0; row < 20; ++row) {
+		for (int column = 0; column < 20; ++column) {
+			const std::string name{ "tok" + std::to_string(row) + "_" + std::to_string(column) };
+			expect_name(name, row * 20 + column);
+			expect_name("TOK" + std::to_string(row) + "_" + std::to_string(column), row * 20 + column);
+			expect_value(row * 20 + column, name);
+		}
+	}
+
+	for (const auto& entry : dp::enum_names<token>::entries) {
+		const auto value{ static_cast<int>(entry.value) };
+		if (value < 1000) continue;
+		expect_name(entry.name, value);
+		expect_value(value, entry.name);
+	}
+	expect_name("X[1]", 1000);
+	expect_name("X{1}", 1001);
+	expect_name("A@", 1002);
+	expect_no_name("x]1]");
+	expect_no_name("tok20_0");
+
+	std::printf("%zu failures\n", failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/*
+*  Runs the floating point conformance corpus against conv_impl::parse_floating_chars, which is what convert_to uses wherever
+*  std::from_chars has no floating point overloads, and for wide strings everywhere. Where from_chars does have them it is checked
+*  against the same corpus, so a disagreement between the two shows up as a failure in one or the other.
+*
+*  long double has no one layout we could write into the corpus, so it is checked against strtold instead; on the same inputs, and on a
+*  second file of halfway points for the x87 format, some of which need over 16k digits to round. Where long double is double
+*  those are just more inputs. Not against from_chars, as libstdc++ reports long double results in the subnormal range as out of range.
+*
+*  Usage: dp_test_float_conformance <corpus file> <long double input file>
+*/
+
+#include "convert.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+	struct expected_result {
+		std::size_t consumed{};
+		std::string value;
+	};
+
+	//The corpus spelling of a successful result
+	template<typename T>
+	std::string describe(T value) {
+		if (std::isnan(value)) return std::signbit(value) ? "-nan" : "nan";
+		using bits_type = std::conditional_t<sizeof(T) == 8, unsigned long long, unsigned int>;
+		bits_type bits{};
+		std::memcpy(&bits, &value, sizeof(bits));
+		char buffer[20]{};
+		std::snprintf(buffer, sizeof(buffer), sizeof(T) == 8 ? "%016llx" : "%08llx", static_cast<unsigned long long>(bits));
+		return buffer;
+	}
+
+	std::string describe(std::errc ec) {
+		return ec == std::errc::invalid_argument ? "invalid" : ec == std::errc::result_out_of_range ? "range" : "error";
+	}
+
+	template<typename T>
+	bool check(const char* parser, std::string_view input, const expected_result& expected, std::size_t consumed, std::errc ec, T value) {
+		const std::string actual{ ec == std::errc{} ? describe(value) : describe(ec) };
+		if (consumed == expected.consumed && actual == expected.value) return true;
+		std::printf("FAIL %s<%s> \"%.*s\": expected %s after %zu characters, got %s after %zu\n", parser, sizeof(T) == 8 ? "double" : "float",
+			static_cast<int>(input.size() > 60 ? 60 : input.size()), input.data(), expected.value.c_str(), expected.consumed, actual.c_str(), consumed);
+		return false;
+	}
+
+	template<typename T>
+	bool run_case(std::string_view input, const std::wstring& wide_input, const expected_result& expected) {
+		bool passed{ true };
+		{
+			T value{};
+			const auto result{ dp::conv_impl::parse_floating_chars(input.data(), input.data() + input.size(), value) };
+			passed &= check("parse_floating_chars", input, expected, static_cast<std::size_t>(result.ptr - input.data()), result.ec, value);
+		}
+		{
+			T value{};
+			const auto result{ dp::conv_impl::parse_floating_chars(wide_input.data(), wide_input.data() + wide_input.size(), value) };
+			passed &= check("parse_floating_chars(wide)", input, expected, static_cast<std::size_t>(result.ptr - wide_input.data()), result.ec, value);
+		}
+		if constexpr (dp::conv_impl::from_chars_exists<T>) {
+			T value{};
+			const auto result{ std::from_chars(input.data(), input.data() + input.size(), value) };
+			passed &= check("std::from_chars", input, expected, static_cast<std::size_t>(result.ptr - input.data()), result.ec, value);
+		}
+		return passed;
+	}
+
+	bool check_long_double(const char* parser, std::string_view input, std::errc expected_ec, std::size_t expected_consumed, long double expected,
+		std::errc ec, std::size_t consumed, long double value) {
+		bool passed{ ec == expected_ec && consumed == expected_consumed };
+		if (passed && ec == std::errc{}) {
+			passed = std::isnan(expected) ? std::isnan(value) : (value == expected && std::signbit(value) == std::signbit(expected));
+		}
+		if (passed) return true;
+		std::printf("FAIL %s<long double> \"%.*s\" (%zu characters): expected %s %La after %zu characters, got %s %La after %zu\n", parser,
+			static_cast<int>(input.size() > 60 ? 60 : input.size()), input.data(), input.size(), describe(expected_ec).c_str(), expected, expected_consumed,
+			describe(ec).c_str(), value, consumed);
+		return false;
+	}
+
+	//The first consumed characters of the input are a valid number, unless it is invalid
+	bool run_long_double_case(std::string_view input, std::size_t consumed, bool invalid) {
+		std::errc expected_ec{ invalid ? std::errc::invalid_argument : std::errc{} };
+		long double expected{ 0 };
+		if (!invalid) {
+			const std::string text{ input.substr(0, consumed) };
+			expected = std::strtold(text.c_str(), nullptr);
+			const auto number{ text.find_first_not_of('-') };
+			const bool special{ number != std::string::npos && ((text[number] | 0x20) == 'i' || (text[number] | 0x20) == 'n') };
+			const bool nonzero{ text.substr(0, text.find_first_of("eE")).find_first_of("123456789") != std::string::npos };
+			if (!special && (std::isinf(expected) || (expected == 0 && nonzero))) expected_ec = std::errc::result_out_of_range;
+		}
+		else {
+			consumed = 0;
+		}
+
+		bool passed{ true };
+		{
+			long double value{};
+			const auto result{ dp::conv_impl::parse_floating_chars(input.data(), input.data() + input.size(), value) };
+			passed &= check_long_double("parse_floating_chars", input, expected_ec, consumed, expected, result.ec, static_cast<std::size_t>(result.ptr - input.data()), value);
+		}
+		{
+			const std::wstring wide_input(input.begin(), input.end());
+			long double value{};
+			const auto result{ dp::conv_impl::parse_floating_chars(wide_input.data(), wide_input.data() + wide_input.size(), value) };
+			passed &= check_long_double("parse_floating_chars(wide)", input, expected_ec, consumed, expected, result.ec, static_cast<std::size_t>(result.ptr - wide_input.data()), value);
+		}
+		return passed;
+	}
+
+}
+
+int main(int argc, char** argv) {
+	if (argc != 3) {
+		std::fprintf(stderr, "Usage: %s <corpus file> <long double input file>\n", argv[0]);
+		return 2;
+	}
+	std::ifstream corpus{ argv[1] };
+	if (!corpus) {
+		std::fprintf(stderr, "Cannot open corpus %s\n", argv[1]);
+		return 2;
+	}
+
+	std::size_t cases{ 0 };
+	std::size_t failures{ 0 };
+	std::string line;
+	while (std::getline(corpus, line)) {
+		if (line.empty() || line[0] == '#') continue;
+
+		//input, consumed, double, float
+		std::string_view fields[4];
+		std::string_view rest{ line };
+		for (auto& field : fields) {
+			const auto tab{ rest.find('\t') };
+			field = rest.substr(0, tab);
+			rest = tab == std::string_view::npos ? std::string_view{} : rest.substr(tab + 1);
+		}
+		if (fields[3].empty()) {
+			std::fprintf(stderr, "Malformed corpus line: %s\n", line.c_str());
+			return 2;
+		}
+
+		const std::string_view input{ fields[0] };
+		const std::wstring wide_input(input.begin(), input.end());
+		const std::size_t consumed{ std::stoul(std::string{ fields[1] }) };
+		++cases;
+		if (!run_case<double>(input, wide_input, { consumed, std::string{ fields[2] } })) ++failures;
+		if (!run_case<float>(input, wide_input, { consumed, std::string{ fields[3] } })) ++failures;
+		if (!run_long_double_case(input, consumed, fields[2] == "invalid")) ++failures;
+	}
+
+	std::ifstream long_double_inputs{ argv[2] };
+	if (!long_double_inputs) {
+		std::fprintf(stderr, "Cannot open long double inputs %s\n", argv[2]);
+		return 2;
+	}
+	while (std::getline(long_double_inputs, line)) {
+		if (line.empty() || line[0] == '#') continue;
+		++cases;
+		if (!run_long_double_case(line, line.size(), false)) ++failures;
+	}
+
+	std::printf("%zu cases, %zu failures\n", cases, failures);
+	return failures == 0 && cases != 0 ? 0 : 1;
+}